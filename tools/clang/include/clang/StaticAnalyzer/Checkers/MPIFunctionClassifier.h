@@ -16,6 +16,10 @@
 #define LLVM_CLANG_LIB_STATICANALYZER_CHECKERS_MPICHECKER_MPIFUNCTIONCLASSIFIER_H
 
 #include "clang/StaticAnalyzer/Core/PathSensitive/CheckerContext.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include <vector>
 
 namespace clang {
 namespace ento {
@@ -31,6 +35,7 @@ public:
 
   // point-to-point identifiers
   bool isPointToPointType(const IdentifierInfo *const IdentInfo) const;
+  bool isBufferedSend(const IdentifierInfo *const IdentInfo) const;
 
   // collective identifiers
   bool isCollectiveType(const IdentifierInfo *const IdentInfo) const;
@@ -41,11 +46,14 @@ public:
   bool isAlltoallType(const IdentifierInfo *const IdentInfo) const;
   bool isReduceType(const IdentifierInfo *const IdentInfo) const;
   bool isBcastType(const IdentifierInfo *const IdentInfo) const;
+  bool isMPI_Barrier(const IdentifierInfo *const IdentInfo) const;
 
   // io-function identifiers
   bool isMPIIO_Type(const IdentifierInfo *const IdentInfo) const;
   bool isMPI_File_open(const IdentifierInfo *const IdentInfo) const;
   bool isMPI_File_close(const IdentifierInfo *const IdentInfo) const;
+  bool isMPI_File_seek(const IdentifierInfo *const IdentInfo) const;
+  bool isMPI_File_set_view(const IdentifierInfo *const IdentInfo) const;
   bool isMPIIO_file_manipulation(const IdentifierInfo *IdentInfo) const;
   bool isMPIIO_collective(const IdentifierInfo *const IdentInfo) const;
   bool isMPIIO_blocking(const IdentifierInfo *IdentInfo) const;
@@ -54,76 +62,188 @@ public:
   bool isMPIIO_individual_file_pointers(const IdentifierInfo *IdentInfo) const;
   bool isMPIIO_shared_file_pointer(const IdentifierInfo *IdentInfo) const;
 
+  // datatype identifiers
+  bool isTypeConstructor(const IdentifierInfo *const IdentInfo) const;
+  bool isNoncontiguousType(const IdentifierInfo *const IdentInfo) const;
+
   // additional identifiers
   bool isMPI_Wait(const IdentifierInfo *const IdentInfo) const;
   bool isMPI_Waitall(const IdentifierInfo *const IdentInfo) const;
   bool isWaitType(const IdentifierInfo *const IdentInfo) const;
+  bool isWaitSomeType(const IdentifierInfo *const IdentInfo) const;
+  bool isTestType(const IdentifierInfo *const IdentInfo) const;
   bool isGet_count(const IdentifierInfo *const IdentInfo) const;
+  bool isMPI_Comm_rank(const IdentifierInfo *const IdentInfo) const;
+  bool isMPI_Comm_size(const IdentifierInfo *const IdentInfo) const;
+
+  // persistent request identifiers
+  bool isPersistentInit(const IdentifierInfo *const IdentInfo) const;
+  bool isMPI_Start(const IdentifierInfo *const IdentInfo) const;
+  bool isMPI_Startall(const IdentifierInfo *const IdentInfo) const;
+  bool isMPI_Request_free(const IdentifierInfo *const IdentInfo) const;
+
+  /// Classification categories of MPI functions. A function can belong to
+  /// several categories, which are combined into a single bitmask per
+  /// identifier.
+  enum Category : uint64_t {
+    NoCategory = 0,
+    AnyMPI = 1u << 0,
+    NonBlocking = 1u << 1,
+    PointToPoint = 1u << 2,
+    Collective = 1u << 3,
+    PointToColl = 1u << 4,
+    CollToPoint = 1u << 5,
+    CollToColl = 1u << 6,
+    Scatter = 1u << 7,
+    Gather = 1u << 8,
+    Allgather = 1u << 9,
+    Alltoall = 1u << 10,
+    Reduce = 1u << 11,
+    Bcast = 1u << 12,
+    IO = 1u << 13,
+    FileOpen = 1u << 14,
+    FileClose = 1u << 15,
+    IODataAccess = 1u << 16,
+    IOBlocking = 1u << 17,
+    IONonBlocking = 1u << 18,
+    IOExplicitOffset = 1u << 19,
+    IOIndividualFilePointer = 1u << 20,
+    IOSharedFilePointer = 1u << 21,
+    Wait = 1u << 22,
+    Waitall = 1u << 23,
+    GetCount = 1u << 24,
+    IOCollective = 1u << 25,
+    CommRank = 1u << 26,
+    CommSize = 1u << 27,
+    PersistentInit = 1u << 28,
+    Start = 1u << 29,
+    RequestFree = 1u << 30,
+    Test = 1u << 31,
+    WaitSome = 1ull << 32,
+    Barrier = 1ull << 33,
+    BufferedSend = 1ull << 34,
+    FileSeek = 1ull << 35,
+    FileSetView = 1ull << 36,
+    TypeConstructor = 1ull << 37,
+    NoncontiguousType = 1ull << 38
+  };
+
+  /// Roles of MPI function arguments. Roles prefixed with 'Out' denote pointer
+  /// arguments the MPI library writes through. A flag is an output telling
+  /// whether an operation completed.
+  enum ArgRole : uint8_t {
+    NoRole = 0,
+    In,
+    Out,
+    Flag,
+    SendBuf,
+    RecvBuf,
+    Count,
+    Counts,
+    Displs,
+    Datatype,
+    Datatypes,
+    OutDatatype,
+    Op,
+    Peer,
+    Root,
+    Tag,
+    Comm,
+    OutComm,
+    Group,
+    OutGroup,
+    Info,
+    OutInfo,
+    Win,
+    OutWin,
+    File,
+    OutFile,
+    Offset,
+    Request,
+    Requests,
+    Status,
+    Statuses,
+    Length
+  };
+
+  /// Maximum number of arguments of an MPI function.
+  static const unsigned MaxArgs = 13;
+
+  /// Signature of an MPI function, as described by MPIFunctions.def.
+  struct Signature {
+    const char *Name;
+    uint64_t Categories;
+    ArgRole Args[MaxArgs];
+
+    unsigned getNumArgs() const;
+
+    ArgRole getRole(unsigned Idx) const {
+      return Idx < MaxArgs ? Args[Idx] : NoRole;
+    }
+
+    /// Returns true if the argument at the index is a send or receive buffer.
+    bool isBuffer(unsigned Idx) const {
+      return getRole(Idx) == SendBuf || getRole(Idx) == RecvBuf;
+    }
+
+    /// Returns true if the function takes at least one send or receive
+    /// buffer.
+    bool hasBuffer() const;
+
+    /// Returns true if the MPI standard permits the library to write through
+    /// the argument at the given index.
+    bool isOutput(unsigned Idx) const;
+
+    /// Returns the index of the first argument with the given role, or -1 if
+    /// the function has no such argument.
+    int getArgIndex(ArgRole Role) const;
+
+    /// Returns the index of the datatype argument describing the buffer at
+    /// the given index, or -1 if the buffer is untyped.
+    int getDatatypeIndex(unsigned BufferIdx) const;
+  };
+
+  /// Returns the signature of a function identifier, or nullptr if the
+  /// identifier does not name a known MPI function.
+  const Signature *getSignature(const IdentifierInfo *const IdentInfo) const {
+    return Signatures.lookup(IdentInfo);
+  }
+
+  /// Returns the category bitmask of a function identifier. Identifiers that
+  /// do not name a known MPI function yield NoCategory. Callers that need to
+  /// test several categories should query the mask once.
+  uint64_t getCategories(const IdentifierInfo *const IdentInfo) const {
+    const Signature *const Sig = getSignature(IdentInfo);
+    return Sig ? Sig->Categories : NoCategory;
+  }
+
+  /// Returns the signatures of all known MPI functions. The table does not
+  /// depend on an ASTContext and can be used to set up AST matchers.
+  static ArrayRef<Signature> getSignatures();
+
+  /// Returns the names of all known MPI functions whose signature satisfies
+  /// the predicate.
+  static std::vector<StringRef>
+  getFunctionNames(llvm::function_ref<bool(const Signature &)> Pred);
+
+  /// Returns the name of the collective counterpart of an independent file
+  /// data access. Accesses through the shared file pointer have an ordered
+  /// counterpart, all others one ending with '_all'. Returns an empty string
+  /// if the function has no collective counterpart.
+  static StringRef getCollectiveCounterpart(StringRef Name);
 
 private:
   // Initializes function identifiers, to recognize them during analysis.
   void identifierInit(ASTContext &ASTCtx);
-  void initPointToPointIdentifiers(ASTContext &ASTCtx);
-  void initCollectiveIdentifiers(ASTContext &ASTCtx);
-  void initIOIdentifiers(ASTContext &ASTCtx);
-  void initAdditionalIdentifiers(ASTContext &ASTCtx);
-
-  // The containers are used, to enable classification of MPI-functions during
-  // analysis.
-  llvm::SmallVector<IdentifierInfo *, 12> MPINonBlockingTypes;
-
-  llvm::SmallVector<IdentifierInfo *, 10> MPIPointToPointTypes;
-  llvm::SmallVector<IdentifierInfo *, 16> MPICollectiveTypes;
-
-  llvm::SmallVector<IdentifierInfo *, 4> MPIPointToCollTypes;
-  llvm::SmallVector<IdentifierInfo *, 4> MPICollToPointTypes;
-  llvm::SmallVector<IdentifierInfo *, 6> MPICollToCollTypes;
-
-  llvm::SmallVector<IdentifierInfo *, 18> MPIIOTypes;
-
-  llvm::SmallVector<IdentifierInfo *, 44> MPIType; //32
-
-  // point-to-point functions
-  IdentifierInfo *IdentInfo_MPI_Send = nullptr, *IdentInfo_MPI_Isend = nullptr,
-      *IdentInfo_MPI_Ssend = nullptr, *IdentInfo_MPI_Issend = nullptr,
-      *IdentInfo_MPI_Bsend = nullptr, *IdentInfo_MPI_Ibsend = nullptr,
-      *IdentInfo_MPI_Rsend = nullptr, *IdentInfo_MPI_Irsend = nullptr,
-      *IdentInfo_MPI_Recv = nullptr, *IdentInfo_MPI_Irecv = nullptr;
-
-  // collective functions
-  IdentifierInfo *IdentInfo_MPI_Scatter = nullptr,
-      *IdentInfo_MPI_Iscatter = nullptr, *IdentInfo_MPI_Gather = nullptr,
-      *IdentInfo_MPI_Igather = nullptr, *IdentInfo_MPI_Allgather = nullptr,
-      *IdentInfo_MPI_Iallgather = nullptr, *IdentInfo_MPI_Bcast = nullptr,
-      *IdentInfo_MPI_Ibcast = nullptr, *IdentInfo_MPI_Reduce = nullptr,
-      *IdentInfo_MPI_Ireduce = nullptr, *IdentInfo_MPI_Allreduce = nullptr,
-      *IdentInfo_MPI_Iallreduce = nullptr, *IdentInfo_MPI_Alltoall = nullptr,
-      *IdentInfo_MPI_Ialltoall = nullptr, *IdentInfo_MPI_Barrier = nullptr;
 
-  // io-function identifiers
-  IdentifierInfo *IdentInfo_MPI_File_open = nullptr,
-                 *IdentInfo_MPI_File_close = nullptr,
-                 *IdentInfo_MPI_File_read = nullptr,
-                 *IdentInfo_MPI_File_write = nullptr,
-                 *IdentInfo_MPI_File_write_at = nullptr,
-                 *IdentInfo_MPI_File_read_at = nullptr,
-                 *IdentInfo_MPI_File_set_view = nullptr,
-                 *IdentInfo_MPI_File_seek = nullptr,
-                 *IdentInfo_MPI_File_seek_shared = nullptr,
-                 *IdentInfo_MPI_Type_create_subarray = nullptr,
-                 *IdentInfo_MPI_File_iread = nullptr,
-                 *IdentInfo_MPI_File_iwrite = nullptr,
-                 *IdentInfo_MPI_File_iread_at = nullptr,
-                 *IdentInfo_MPI_File_iwrite_at = nullptr,
-                 *IdentInfo_MPI_File_write_shared = nullptr,
-                 *IdentInfo_MPI_File_read_shared = nullptr,
-                 *IdentInfo_MPI_File_iwrite_shared = nullptr,
-                 *IdentInfo_MPI_File_iread_shared = nullptr;
-
-  // additional functions
-  IdentifierInfo *IdentInfo_MPI_Comm_rank = nullptr,
-      *IdentInfo_MPI_Comm_size = nullptr, *IdentInfo_MPI_Wait = nullptr,
-      *IdentInfo_MPI_Waitall = nullptr,*IdentInfo_MPI_Get_count = nullptr;
+  bool hasCategory(const IdentifierInfo *const IdentInfo,
+                   uint64_t Cats) const {
+    return getCategories(IdentInfo) & Cats;
+  }
+
+  // Maps the identifiers of all known MPI functions to their signatures, so
+  // that every classification query is answered by a single lookup.
+  llvm::DenseMap<const IdentifierInfo *, const Signature *> Signatures;
 };
 
 } // end of namespace: mpi
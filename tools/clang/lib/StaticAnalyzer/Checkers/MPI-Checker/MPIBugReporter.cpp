@@ -22,7 +22,7 @@ namespace ento {
 namespace mpi {
 
 void MPIBugReporter::reportDoubleNonblocking(
-    const CallEvent &MPICallEvent, const ento::mpi::Request &Req,
+    const CallEvent &MPICallEvent, const MPIResource &Req,
     const MemRegion *const RequestRegion,
     const ExplodedNode *const ExplNode,
     BugReporter &BReporter) const {
@@ -40,19 +40,18 @@ void MPIBugReporter::reportDoubleNonblocking(
   if (Range.isValid())
     Report->addRange(Range);
 
-  Report->addVisitor(llvm::make_unique<RequestNodeVisitor>(
+  Report->addVisitor(llvm::make_unique<ResourceNodeVisitor>(
       RequestRegion, "Request is previously used by nonblocking call here. "));
   Report->markInteresting(RequestRegion);
 
   BReporter.emitReport(std::move(Report));
 }
 
-// test function
 void MPIBugReporter::reportDoubleOpen(const CallEvent &MPICallEvent,
-                                const ento::mpi::MPIFile &Fh,
-                                const MemRegion *const MPIFileRegion,
-                                const ExplodedNode *const ExplNode,
-                                BugReporter &BReporter) const {
+                                      const MPIResource &Fh,
+                                      const MemRegion *const MPIFileRegion,
+                                      const ExplodedNode *const ExplNode,
+                                      BugReporter &BReporter) const {
   std::string ErrorText;
   ErrorText = "Double open on file " +
               MPIFileRegion->getDescriptiveName() + ". ";
@@ -64,14 +63,14 @@ void MPIBugReporter::reportDoubleOpen(const CallEvent &MPICallEvent,
   if (Range.isValid())
     Report->addRange(Range);
 
-  Report->addVisitor(llvm::make_unique<MPIFileNodeVisitor>(
+  Report->addVisitor(llvm::make_unique<ResourceNodeVisitor>(
       MPIFileRegion, "File is previously opened here. "));
   Report->markInteresting(MPIFileRegion);
   BReporter.emitReport(std::move(Report));
 }
 
 void MPIBugReporter::reportDoubleClose(const CallEvent &MPICallEvent,
-                                       const ento::mpi::MPIFile &Fh,
+                                       const MPIResource &Fh,
                                        const MemRegion *const MPIFileRegion,
                                        const ExplodedNode *const ExplNode,
                                        BugReporter &BReporter) const {
@@ -88,21 +87,20 @@ void MPIBugReporter::reportDoubleClose(const CallEvent &MPICallEvent,
   if (Range.isValid())
     Report->addRange(Range);
 
-  Report->addVisitor(llvm::make_unique<MPIFileNodeVisitor>(
+  Report->addVisitor(llvm::make_unique<ResourceNodeVisitor>(
       MPIFileRegion, "File is previously closed here. "));
   Report->markInteresting(MPIFileRegion);
 
   BReporter.emitReport(std::move(Report));
 }
 
-// in progress
-void MPIBugReporter::reportFileLeak(const ento::mpi::MPIFile &Fh,
+void MPIBugReporter::reportFileLeak(const MPIResource &Fh,
                                     const MemRegion *const MPIFileRegion,
                                     const ExplodedNode *const ExplNode,
                                     BugReporter &BReporter) const {
   std::string ErrorText;
-  ErrorText = "File  " + MPIFileRegion->getDescriptiveName() +
-              "has no matching close. ";
+  ErrorText = "File " + MPIFileRegion->getDescriptiveName() +
+              " has no matching close. ";
 
   auto Report =
       llvm::make_unique<BugReport>(*FileLeakBugType, ErrorText, ExplNode);
@@ -111,15 +109,74 @@ void MPIBugReporter::reportFileLeak(const ento::mpi::MPIFile &Fh,
   if (Range.isValid())
     Report->addRange(Range);
 
-  Report->addVisitor(llvm::make_unique<MPIFileNodeVisitor>(
+  Report->addVisitor(llvm::make_unique<ResourceNodeVisitor>(
       MPIFileRegion, "File was previously opened here. "));
   Report->markInteresting(MPIFileRegion);
 
   BReporter.emitReport(std::move(Report));
 }
 
+void MPIBugReporter::reportAccessAfterClose(
+    const CallEvent &CE, const MemRegion *const MPIFileRegion,
+    const ExplodedNode *const ExplNode, BugReporter &BReporter) const {
+  std::string ErrorText{"File " + MPIFileRegion->getDescriptiveName() +
+                        " is used after it was closed. "};
+
+  auto Report = llvm::make_unique<BugReport>(*AccessAfterCloseBugType,
+                                             ErrorText, ExplNode);
+
+  Report->addRange(CE.getSourceRange());
+  SourceRange Range = MPIFileRegion->sourceRange();
+  if (Range.isValid())
+    Report->addRange(Range);
+
+  Report->addVisitor(llvm::make_unique<ResourceNodeVisitor>(
+      MPIFileRegion, "File is previously closed here. "));
+  Report->markInteresting(MPIFileRegion);
+
+  BReporter.emitReport(std::move(Report));
+}
+
+void MPIBugReporter::reportUnopenedFile(const CallEvent &CE,
+                                        const MemRegion *const MPIFileRegion,
+                                        const ExplodedNode *const ExplNode,
+                                        BugReporter &BReporter) const {
+  std::string ErrorText{"File " + MPIFileRegion->getDescriptiveName() +
+                        " is used without a matching open. "};
+
+  auto Report =
+      llvm::make_unique<BugReport>(*UnopenedFileBugType, ErrorText, ExplNode);
+
+  Report->addRange(CE.getSourceRange());
+  SourceRange Range = MPIFileRegion->sourceRange();
+  if (Range.isValid())
+    Report->addRange(Range);
+
+  BReporter.emitReport(std::move(Report));
+}
+
+void MPIBugReporter::reportViewTypeMismatch(
+    const CallEvent &CE, const CallExpr &SetView,
+    const MemRegion *const MPIFileRegion, const ExplodedNode *const ExplNode,
+    BugReporter &BReporter) const {
+  std::string ErrorText{"Datatype of the access is not built from the etype "
+                        "of the view of file " +
+                        MPIFileRegion->getDescriptiveName() + ". "};
+
+  auto Report = llvm::make_unique<BugReport>(*ViewTypeMismatchBugType,
+                                             ErrorText, ExplNode);
+
+  Report->addRange(CE.getSourceRange());
+  Report->addNote("View is set here. ",
+                  PathDiagnosticLocation::createBegin(
+                      &SetView, BReporter.getSourceManager(),
+                      ExplNode->getLocationContext()));
+
+  BReporter.emitReport(std::move(Report));
+}
+
 void MPIBugReporter::reportMissingWait(
-    const ento::mpi::Request &Req, const MemRegion *const RequestRegion,
+    const MPIResource &Req, const MemRegion *const RequestRegion,
     const ExplodedNode *const ExplNode,
     BugReporter &BReporter) const {
   std::string ErrorText{"Request " + RequestRegion->getDescriptiveName() +
@@ -131,7 +188,7 @@ void MPIBugReporter::reportMissingWait(
   SourceRange Range = RequestRegion->sourceRange();
   if (Range.isValid())
     Report->addRange(Range);
-  Report->addVisitor(llvm::make_unique<RequestNodeVisitor>(
+  Report->addVisitor(llvm::make_unique<ResourceNodeVisitor>(
       RequestRegion, "Request is previously used by nonblocking call here. "));
   Report->markInteresting(RequestRegion);
 
@@ -156,48 +213,235 @@ void MPIBugReporter::reportUnmatchedWait(
   BReporter.emitReport(std::move(Report));
 }
 
-std::shared_ptr<PathDiagnosticPiece>
-MPIBugReporter::RequestNodeVisitor::VisitNode(const ExplodedNode *N,
-                                              const ExplodedNode *PrevN,
-                                              BugReporterContext &BRC,
-                                              BugReport &BR) {
+void MPIBugReporter::reportDoubleStart(const CallEvent &CE,
+                                       const MemRegion *const RequestRegion,
+                                       const ExplodedNode *const ExplNode,
+                                       BugReporter &BReporter) const {
+  std::string ErrorText{"Double start on persistent request " +
+                        RequestRegion->getDescriptiveName() + ". "};
 
-  if (IsNodeFound)
-    return nullptr;
+  auto Report =
+      llvm::make_unique<BugReport>(*DoubleStartBugType, ErrorText, ExplNode);
+
+  Report->addRange(CE.getSourceRange());
+  SourceRange Range = RequestRegion->sourceRange();
+  if (Range.isValid())
+    Report->addRange(Range);
+  Report->addVisitor(llvm::make_unique<ResourceNodeVisitor>(
+      RequestRegion, "Request is previously started here. "));
+  Report->markInteresting(RequestRegion);
 
-  const Request *const Req = N->getState()->get<RequestMap>(RequestRegion);
-  const Request *const PrevReq =
-      PrevN->getState()->get<RequestMap>(RequestRegion);
+  BReporter.emitReport(std::move(Report));
+}
 
-  // Check if request was previously unused or in a different state.
-  if ((Req && !PrevReq) || (Req->CurrentState != PrevReq->CurrentState)) {
-    IsNodeFound = true;
+void MPIBugReporter::reportPersistentRequestLeak(
+    const MPIResource &Req, const MemRegion *const RequestRegion,
+    const ExplodedNode *const ExplNode, BugReporter &BReporter) const {
+  std::string ErrorText{"Persistent request " +
+                        RequestRegion->getDescriptiveName() +
+                        " is not freed. "};
 
-    ProgramPoint P = PrevN->getLocation();
-    PathDiagnosticLocation L =
-        PathDiagnosticLocation::create(P, BRC.getSourceManager());
+  auto Report = llvm::make_unique<BugReport>(*PersistentRequestLeakBugType,
+                                             ErrorText, ExplNode);
 
-    return std::make_shared<PathDiagnosticEventPiece>(L, ErrorText);
+  SourceRange Range = RequestRegion->sourceRange();
+  if (Range.isValid())
+    Report->addRange(Range);
+  Report->addVisitor(llvm::make_unique<ResourceNodeVisitor>(
+      RequestRegion, "Persistent request is previously used here. "));
+  Report->markInteresting(RequestRegion);
+
+  BReporter.emitReport(std::move(Report));
+}
+
+void MPIBugReporter::reportNoOverlap(const CheckName &Check,
+                                     const CallEvent &CE,
+                                     const MemRegion *const RequestRegion,
+                                     const ExplodedNode *const ExplNode,
+                                     BugReporter &BReporter) const {
+  if (!NoOverlapBugType) {
+    NoOverlapBugType.reset(
+        new BugType(Check, "No communication overlap", MPIPerformance));
   }
+  std::string ErrorText{"Request " + RequestRegion->getDescriptiveName() +
+                        " is waited for right after its nonblocking call, "
+                        "no work overlaps the communication. "};
 
-  return nullptr;
+  auto Report =
+      llvm::make_unique<BugReport>(*NoOverlapBugType, ErrorText, ExplNode);
+
+  Report->addRange(CE.getSourceRange());
+  SourceRange Range = RequestRegion->sourceRange();
+  if (Range.isValid())
+    Report->addRange(Range);
+  Report->addVisitor(llvm::make_unique<ResourceNodeVisitor>(
+      RequestRegion, "Request is previously used by nonblocking call here. "));
+  Report->markInteresting(RequestRegion);
+
+  BReporter.emitReport(std::move(Report));
+}
+
+void MPIBugReporter::reportSpinningTest(const CheckName &Check,
+                                        const CallEvent &CE,
+                                        const MemRegion *const RequestRegion,
+                                        const ExplodedNode *const ExplNode,
+                                        BugReporter &BReporter) const {
+  if (!SpinningTestBugType) {
+    SpinningTestBugType.reset(
+        new BugType(Check, "Spinning test", MPIPerformance));
+  }
+  std::string ErrorText{"Request " + RequestRegion->getDescriptiveName() +
+                        " is tested again without work in between, "
+                        "use a wait instead of spinning. "};
+
+  auto Report =
+      llvm::make_unique<BugReport>(*SpinningTestBugType, ErrorText, ExplNode);
+
+  Report->addRange(CE.getSourceRange());
+  SourceRange Range = RequestRegion->sourceRange();
+  if (Range.isValid())
+    Report->addRange(Range);
+
+  BReporter.emitReport(std::move(Report));
+}
+
+void MPIBugReporter::reportRedundantBarrier(
+    const CheckName &Check, const CallEvent &CE, const CallExpr &Adjacent,
+    const bool IsCallRedundant, const bool InLoop,
+    const ExplodedNode *const ExplNode, BugReporter &BReporter) const {
+  if (!RedundantBarrierBugType) {
+    RedundantBarrierBugType.reset(
+        new BugType(Check, "Redundant barrier", MPIPerformance));
+  }
+  const FunctionDecl *const AdjacentFD = Adjacent.getDirectCallee();
+  const std::string AdjacentName =
+      AdjacentFD ? AdjacentFD->getNameAsString() : "collective";
+  std::string ErrorText{
+      IsCallRedundant
+          ? "Barrier is redundant, '" + AdjacentName +
+                "' right before synchronizes the communicator as well. "
+          : "Barrier right before is redundant, '" +
+                CE.getCalleeIdentifier()->getName().str() +
+                "' synchronizes the communicator as well. "};
+  if (InLoop)
+    ErrorText += "Removing it saves one synchronization per loop iteration. ";
+
+  auto Report = llvm::make_unique<BugReport>(*RedundantBarrierBugType,
+                                             ErrorText, ExplNode);
+  Report->addRange(CE.getSourceRange());
+  Report->addNote(IsCallRedundant ? "Communicator is synchronized here. "
+                                  : "Barrier is called here. ",
+                  PathDiagnosticLocation::createBegin(
+                      &Adjacent, BReporter.getSourceManager(),
+                      ExplNode->getLocationContext()));
+
+  BReporter.emitReport(std::move(Report));
+}
+
+void MPIBugReporter::reportBlockingCollective(
+    const CheckName &Check, const CallExpr &Collective,
+    StringRef NonblockingName, unsigned Work,
+    const ExplodedNode *const ExplNode, BugReporter &BReporter) const {
+  if (!BlockingCollectiveBugType) {
+    BlockingCollectiveBugType.reset(new BugType(
+        Check, "Blocking collective without overlap", MPIPerformance));
+  }
+  const FunctionDecl *const FD = Collective.getDirectCallee();
+  std::string ErrorText{
+      "Buffer of '" + (FD ? FD->getNameAsString() : "collective") +
+      "' is first used after " + std::to_string(Work) +
+      (Work == 1 ? " step" : " steps") + " of independent work, '" +
+      NonblockingName.str() +
+      "' and a wait before this use let the work overlap. "};
+
+  auto Report = llvm::make_unique<BugReport>(*BlockingCollectiveBugType,
+                                             ErrorText, ExplNode);
+  Report->addNote("Blocking collective is called here. ",
+                  PathDiagnosticLocation::createBegin(
+                      &Collective, BReporter.getSourceManager(),
+                      ExplNode->getLocationContext()));
+
+  BReporter.emitReport(std::move(Report));
+}
+
+void MPIBugReporter::reportHeadToHeadSend(const CheckName &Check,
+                                          const CallExpr &Send,
+                                          const CallExpr &PeerSend,
+                                          const CallExpr &Recv,
+                                          const llvm::APSInt &Peer,
+                                          const LocationContext *const LCtx,
+                                          BugReporter &BReporter) const {
+  if (!HeadToHeadSendBugType) {
+    HeadToHeadSendBugType.reset(
+        new BugType(Check, "Head-to-head send", MPIPerformance));
+  }
+  const std::string PeerRank = Peer.toString(10);
+  std::string ErrorText{
+      "Receive from rank " + PeerRank + " follows a blocking send to it, "
+      "while rank " + PeerRank + " also sends first. The exchange only "
+      "completes while the messages fit the eager protocol, use "
+      "'MPI_Sendrecv' or post a nonblocking receive before the send. "};
+
+  // The paths are matched after the analysis, so the report is attached to
+  // the receive instead of a node.
+  const SourceManager &SM = BReporter.getSourceManager();
+  auto Report = llvm::make_unique<BugReport>(
+      *HeadToHeadSendBugType, ErrorText,
+      PathDiagnosticLocation::createBegin(&Recv, SM, LCtx));
+  Report->addRange(Recv.getSourceRange());
+  Report->addNote("Blocking send is called here. ",
+                  PathDiagnosticLocation::createBegin(&Send, SM, LCtx));
+  Report->addNote("Rank " + PeerRank + " sends before receiving here. ",
+                  PathDiagnosticLocation::createBegin(&PeerSend, SM, LCtx));
+
+  BReporter.emitReport(std::move(Report));
+}
+
+void MPIBugReporter::reportNoncontiguousIndependentAccess(
+    const CheckName &Check, const CallEvent &CE, const CallExpr &SetView,
+    StringRef CollectiveName, const MemRegion *const MPIFileRegion,
+    const ExplodedNode *const ExplNode, BugReporter &BReporter) const {
+  if (!NoncontiguousIndependentAccessBugType) {
+    NoncontiguousIndependentAccessBugType.reset(new BugType(
+        Check, "Independent noncontiguous file access", MPIPerformance));
+  }
+  std::string ErrorText{
+      "Independent access to file " + MPIFileRegion->getDescriptiveName() +
+      " through a noncontiguous view is split into one request per "
+      "contiguous block, "};
+  ErrorText += CollectiveName.empty()
+                   ? "use a collective access"
+                   : "use '" + CollectiveName.str() + "'";
+  ErrorText += " to let the library merge the blocks of all processes. ";
+
+  auto Report = llvm::make_unique<BugReport>(
+      *NoncontiguousIndependentAccessBugType, ErrorText, ExplNode);
+
+  Report->addRange(CE.getSourceRange());
+  Report->addNote("Noncontiguous view is set here. ",
+                  PathDiagnosticLocation::createBegin(
+                      &SetView, BReporter.getSourceManager(),
+                      ExplNode->getLocationContext()));
+
+  BReporter.emitReport(std::move(Report));
 }
 
 std::shared_ptr<PathDiagnosticPiece>
-MPIBugReporter::MPIFileNodeVisitor::VisitNode(const ExplodedNode *N,
-                                              const ExplodedNode *PrevN,
-                                              BugReporterContext &BRC,
-                                              BugReport &BR) {
+MPIBugReporter::ResourceNodeVisitor::VisitNode(const ExplodedNode *N,
+                                               const ExplodedNode *PrevN,
+                                               BugReporterContext &BRC,
+                                               BugReport &BR) {
 
   if (IsNodeFound)
     return nullptr;
 
-  const MPIFile *const Fh = N->getState()->get<MPIFileMap>(MPIFileRegion);
-  const MPIFile *const PrevFh =
-      PrevN->getState()->get<MPIFileMap>(MPIFileRegion);
+  const MPIResource *const Res =
+      N->getState()->get<MPIResourceMap>(ResourceRegion);
+  const MPIResource *const PrevRes =
+      PrevN->getState()->get<MPIResourceMap>(ResourceRegion);
 
-  // check if the file was previously unused
-  if ((Fh && !PrevFh) || (Fh->CurrentState != PrevFh->CurrentState)) {
+  // Check if the resource was previously unused or in a different state.
+  if (Res && (!PrevRes || Res->CurrentState != PrevRes->CurrentState)) {
     IsNodeFound = true;
 
     ProgramPoint P = PrevN->getLocation();
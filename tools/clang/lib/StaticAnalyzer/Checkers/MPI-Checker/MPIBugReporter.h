@@ -17,7 +17,6 @@
 #define LLVM_CLANG_LIB_STATICANALYZER_CHECKERS_MPICHECKER_MPIBUGREPORTER_H
 
 #include "MPITypes.h"
-#include "MPITypes_2.h"
 #include "clang/StaticAnalyzer/Core/BugReporter/BugType.h"
 
 namespace clang {
@@ -35,6 +34,15 @@ public:
     FileLeakBugType.reset(
         new BugType(&CB, "File has not been closed after open", MPIError));
     DoubleOpenBugType.reset(new BugType(&CB, "Double Open", MPIError));
+    AccessAfterCloseBugType.reset(
+        new BugType(&CB, "File access after close", MPIError));
+    UnopenedFileBugType.reset(
+        new BugType(&CB, "Access to unopened file", MPIError));
+    ViewTypeMismatchBugType.reset(
+        new BugType(&CB, "Datatype mismatch with file view", MPIError));
+    DoubleStartBugType.reset(new BugType(&CB, "Double start", MPIError));
+    PersistentRequestLeakBugType.reset(
+        new BugType(&CB, "Persistent request has not been freed", MPIError));
   }
 
   /// Report duplicate request use by nonblocking calls without intermediate
@@ -46,7 +54,7 @@ public:
   /// \param ExplNode node in the graph the bug appeared at
   /// \param BReporter bug reporter for current context
   void reportDoubleNonblocking(const CallEvent &MPICallEvent,
-                               const Request &Req,
+                               const MPIResource &Req,
                                const MemRegion *const RequestRegion,
                                const ExplodedNode *const ExplNode,
                               BugReporter &BReporter) const;
@@ -57,7 +65,7 @@ public:
   /// \param RequestRegion memory region of the request
   /// \param ExplNode node in the graph the bug appeared at
   /// \param BReporter bug reporter for current context
-  void reportMissingWait(const Request &Req,
+  void reportMissingWait(const MPIResource &Req,
                          const MemRegion *const RequestRegion,
                          const ExplodedNode *const ExplNode,
                          BugReporter &BReporter) const;
@@ -73,23 +81,192 @@ public:
                            const ExplodedNode *const ExplNode,
                            BugReporter &BReporter) const;
 
-  void reportDoubleClose(const CallEvent &MPICallEvent,
-                          const MPIFile &fh,
+  /// Report a file handle that is closed again without intermediate open.
+  ///
+  /// \param MPICallEvent close call that uses the file handle
+  /// \param Fh file handle that was closed before
+  /// \param MPIFileRegion memory region of the file handle
+  /// \param ExplNode node in the graph the bug appeared at
+  /// \param BReporter bug reporter for current context
+  void reportDoubleClose(const CallEvent &MPICallEvent, const MPIResource &Fh,
+                         const MemRegion *const MPIFileRegion,
+                         const ExplodedNode *const ExplNode,
+                         BugReporter &BReporter) const;
+
+  /// Report a file that is still open when its handle is no longer
+  /// reachable or the program ends.
+  ///
+  /// \param Fh file handle that is not closed
+  /// \param MPIFileRegion memory region of the file handle
+  /// \param ExplNode node in the graph the bug appeared at
+  /// \param BReporter bug reporter for current context
+  void reportFileLeak(const MPIResource &Fh,
+                      const MemRegion *const MPIFileRegion,
+                      const ExplodedNode *const ExplNode,
+                      BugReporter &BReporter) const;
+
+  /// Report a file handle that is opened again without intermediate close.
+  ///
+  /// \param MPICallEvent open call that uses the file handle
+  /// \param Fh file handle that is still open
+  /// \param MPIFileRegion memory region of the file handle
+  /// \param ExplNode node in the graph the bug appeared at
+  /// \param BReporter bug reporter for current context
+  void reportDoubleOpen(const CallEvent &MPICallEvent, const MPIResource &Fh,
+                        const MemRegion *const MPIFileRegion,
+                        const ExplodedNode *const ExplNode,
+                        BugReporter &BReporter) const;
+
+  /// Report a call using a file handle that was closed before.
+  ///
+  /// \param CE call that uses the file handle
+  /// \param MPIFileRegion memory region of the file handle
+  /// \param ExplNode node in the graph the bug appeared at
+  /// \param BReporter bug reporter for current context
+  void reportAccessAfterClose(const CallEvent &CE,
+                              const MemRegion *const MPIFileRegion,
+                              const ExplodedNode *const ExplNode,
+                              BugReporter &BReporter) const;
+
+  /// Report a call using a file handle that was never opened.
+  ///
+  /// \param CE call that uses the file handle
+  /// \param MPIFileRegion memory region of the file handle
+  /// \param ExplNode node in the graph the bug appeared at
+  /// \param BReporter bug reporter for current context
+  void reportUnopenedFile(const CallEvent &CE,
                           const MemRegion *const MPIFileRegion,
                           const ExplodedNode *const ExplNode,
                           BugReporter &BReporter) const;
 
-  void reportFileLeak(const MPIFile &fh, const MemRegion *const MPIFileRegion,
-                      const ExplodedNode *const ExplNode,
-                      BugReporter &BReporter) const;
+  /// Report a data access whose datatype is not built from the etype of the
+  /// view set on the file.
+  ///
+  /// \param CE data access that uses the file handle
+  /// \param SetView call that set the view
+  /// \param MPIFileRegion memory region of the file handle
+  /// \param ExplNode node in the graph the bug appeared at
+  /// \param BReporter bug reporter for current context
+  void reportViewTypeMismatch(const CallEvent &CE, const CallExpr &SetView,
+                              const MemRegion *const MPIFileRegion,
+                              const ExplodedNode *const ExplNode,
+                              BugReporter &BReporter) const;
+
+  /// Report a persistent request that is started while it is still active.
+  ///
+  /// \param CE start call that uses the request
+  /// \param RequestRegion memory region of the request
+  /// \param ExplNode node in the graph the bug appeared at
+  /// \param BReporter bug reporter for current context
+  void reportDoubleStart(const CallEvent &CE,
+                         const MemRegion *const RequestRegion,
+                         const ExplodedNode *const ExplNode,
+                         BugReporter &BReporter) const;
 
-  void reportDoubleOpen(const CallEvent &MPICallEvent, const ento::mpi::MPIFile &Fh,
-                  const MemRegion *const MPIFileRegion,
-                  const ExplodedNode *const ExplNode,
-                  BugReporter &BReporter) const;
+  /// Report a persistent request that is not freed.
+  ///
+  /// \param Req persistent request that is not freed
+  /// \param RequestRegion memory region of the request
+  /// \param ExplNode node in the graph the bug appeared at
+  /// \param BReporter bug reporter for current context
+  void reportPersistentRequestLeak(const MPIResource &Req,
+                                   const MemRegion *const RequestRegion,
+                                   const ExplodedNode *const ExplNode,
+                                   BugReporter &BReporter) const;
+
+  /// Report a wait on a request that is reached right after the nonblocking
+  /// call of the request, without any work in between to overlap the
+  /// communication with.
+  ///
+  /// \param Check name of the performance check reporting the wait
+  /// \param CE wait call that uses the request
+  /// \param RequestRegion memory region of the request
+  /// \param ExplNode node in the graph the bug appeared at
+  /// \param BReporter bug reporter for current context
+  void reportNoOverlap(const CheckName &Check, const CallEvent &CE,
+                       const MemRegion *const RequestRegion,
+                       const ExplodedNode *const ExplNode,
+                       BugReporter &BReporter) const;
+
+  /// Report a test of requests, that is reached right after a previous test
+  /// did not complete them, without any work in between.
+  ///
+  /// \param Check name of the performance check reporting the test
+  /// \param CE test call that uses the requests
+  /// \param RequestRegion memory region of the requests
+  /// \param ExplNode node in the graph the bug appeared at
+  /// \param BReporter bug reporter for current context
+  void reportSpinningTest(const CheckName &Check, const CallEvent &CE,
+                          const MemRegion *const RequestRegion,
+                          const ExplodedNode *const ExplNode,
+                          BugReporter &BReporter) const;
+
+  /// Report a barrier, that is called right before or after a collective
+  /// synchronizing the same communicator.
+  ///
+  /// \param Check name of the performance check reporting the barrier
+  /// \param CE synchronizing call the report is attached to
+  /// \param Adjacent synchronizing call made right before
+  /// \param IsCallRedundant true if CE is the redundant barrier, false if
+  /// Adjacent is
+  /// \param InLoop true if the barrier is called in a loop
+  /// \param ExplNode node in the graph the bug appeared at
+  /// \param BReporter bug reporter for current context
+  void reportRedundantBarrier(const CheckName &Check, const CallEvent &CE,
+                              const CallExpr &Adjacent,
+                              const bool IsCallRedundant, const bool InLoop,
+                              const ExplodedNode *const ExplNode,
+                              BugReporter &BReporter) const;
+
+  /// Report a blocking collective, whose buffers are not used before work
+  /// that could overlap its nonblocking variant.
+  ///
+  /// \param Check name of the performance check reporting the collective
+  /// \param Collective blocking collective call
+  /// \param NonblockingName name of the nonblocking variant
+  /// \param Work number of stores and calls that could overlap
+  /// \param ExplNode node in the graph the buffer is used at
+  /// \param BReporter bug reporter for current context
+  void reportBlockingCollective(const CheckName &Check,
+                                const CallExpr &Collective,
+                                StringRef NonblockingName, unsigned Work,
+                                const ExplodedNode *const ExplNode,
+                                BugReporter &BReporter) const;
+
+  /// Report two processes, that both call a blocking send to each other
+  /// before receiving from each other.
+  ///
+  /// \param Check name of the performance check reporting the exchange
+  /// \param Send blocking send of the reported path
+  /// \param PeerSend blocking send of the peer
+  /// \param Recv blocking receive following the send
+  /// \param Peer rank the reported path sends to
+  /// \param LCtx location context of the receive
+  /// \param BReporter bug reporter for current context
+  void reportHeadToHeadSend(const CheckName &Check, const CallExpr &Send,
+                            const CallExpr &PeerSend, const CallExpr &Recv,
+                            const llvm::APSInt &Peer,
+                            const LocationContext *const LCtx,
+                            BugReporter &BReporter) const;
+
+  /// Report an independent data access to a file, whose view has a
+  /// noncontiguous filetype.
+  ///
+  /// \param Check name of the performance check reporting the access
+  /// \param CE data access that uses the file handle
+  /// \param SetView call that set the view
+  /// \param CollectiveName collective variant of the access, may be empty
+  /// \param MPIFileRegion memory region of the file handle
+  /// \param ExplNode node in the graph the bug appeared at
+  /// \param BReporter bug reporter for current context
+  void reportNoncontiguousIndependentAccess(
+      const CheckName &Check, const CallEvent &CE, const CallExpr &SetView,
+      StringRef CollectiveName, const MemRegion *const MPIFileRegion,
+      const ExplodedNode *const ExplNode, BugReporter &BReporter) const;
 
 private:
   const std::string MPIError = "MPI Error";
+  const std::string MPIPerformance = "MPI Performance";
 
   // path-sensitive bug types
   std::unique_ptr<BugType> UnmatchedWaitBugType;
@@ -98,19 +275,34 @@ private:
   std::unique_ptr<BugType> DoubleCloseBugType;
   std::unique_ptr<BugType> FileLeakBugType;
   std::unique_ptr<BugType> DoubleOpenBugType;
+  std::unique_ptr<BugType> AccessAfterCloseBugType;
+  std::unique_ptr<BugType> UnopenedFileBugType;
+  std::unique_ptr<BugType> ViewTypeMismatchBugType;
+  std::unique_ptr<BugType> DoubleStartBugType;
+  std::unique_ptr<BugType> PersistentRequestLeakBugType;
+
+  // Performance bug types are created on first use, as they belong to a
+  // separate check.
+  mutable std::unique_ptr<BugType> NoOverlapBugType;
+  mutable std::unique_ptr<BugType> SpinningTestBugType;
+  mutable std::unique_ptr<BugType> RedundantBarrierBugType;
+  mutable std::unique_ptr<BugType> BlockingCollectiveBugType;
+  mutable std::unique_ptr<BugType> HeadToHeadSendBugType;
+  mutable std::unique_ptr<BugType> NoncontiguousIndependentAccessBugType;
 
-  /// Bug visitor class to find the node where the request region was
-  /// previously used in order to include it into the BugReport path.
-  class RequestNodeVisitor : public BugReporterVisitorImpl<RequestNodeVisitor> {
+  /// Bug visitor class to find the node where the region of an MPI resource
+  /// was previously used in order to include it into the BugReport path.
+  class ResourceNodeVisitor
+      : public BugReporterVisitorImpl<ResourceNodeVisitor> {
   public:
-    RequestNodeVisitor(const MemRegion *const MemoryRegion,
-                       const std::string &ErrText)
-        : RequestRegion(MemoryRegion), ErrorText(ErrText) {}
+    ResourceNodeVisitor(const MemRegion *const MemoryRegion,
+                        const std::string &ErrText)
+        : ResourceRegion(MemoryRegion), ErrorText(ErrText) {}
 
     void Profile(llvm::FoldingSetNodeID &ID) const override {
       static int X = 0;
       ID.AddPointer(&X);
-      ID.AddPointer(RequestRegion);
+      ID.AddPointer(ResourceRegion);
     }
 
     std::shared_ptr<PathDiagnosticPiece> VisitNode(const ExplodedNode *N,
@@ -119,35 +311,10 @@ private:
                                                    BugReport &BR) override;
 
   private:
-    const MemRegion *const RequestRegion;
+    const MemRegion *const ResourceRegion;
     bool IsNodeFound = false;
     std::string ErrorText;
-    };
-
-    // class to observe the path of the used file for the bugreport
-    class MPIFileNodeVisitor
-        : public BugReporterVisitorImpl<MPIFileNodeVisitor> {
-    public:
-      MPIFileNodeVisitor(const MemRegion *const MemoryRegion,
-                         const std::string &ErrText)
-          : MPIFileRegion(MemoryRegion), ErrorText(ErrText) {}
-
-      void Profile(llvm::FoldingSetNodeID &ID) const override {
-        static int X = 0;
-        ID.AddPointer(&X);
-        ID.AddPointer(MPIFileRegion);
-      }
-
-      std::shared_ptr<PathDiagnosticPiece> VisitNode(const ExplodedNode *N,
-                                                     const ExplodedNode *PrevN,
-                                                     BugReporterContext &BRC,
-                                                     BugReport &BR) override;
-
-    private:
-      const MemRegion *const MPIFileRegion;
-      bool IsNodeFound = false;
-      std::string ErrorText;
-    };
+  };
 };
 
 } // end of namespace: mpi
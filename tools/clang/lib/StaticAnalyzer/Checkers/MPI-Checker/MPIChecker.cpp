@@ -17,202 +17,756 @@
 
 #include "MPIChecker.h"
 #include "../ClangSACheckers.h"
+#include "clang/AST/ParentMap.h"
+#include "clang/AST/StmtCXX.h"
+#include "llvm/ADT/SmallSet.h"
 
 namespace clang {
 namespace ento {
 namespace mpi {
 
-void MPIChecker::checkDoubleNonblocking(const CallEvent &PreCallEvent,
-                                        CheckerContext &Ctx) const {
-  if (!FuncClassifier->isNonBlockingType(PreCallEvent.getCalleeIdentifier())) {
-    return;
+bool MPIChecker::evalCall(const CallExpr *CE, CheckerContext &Ctx) const {
+  const FunctionDecl *const FD = Ctx.getCalleeDecl(CE);
+  if (!FD || !FD->getDeclContext()->getRedeclContext()->isTranslationUnit())
+    return false;
+
+  dynamicInit(Ctx);
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier->getSignature(FD->getIdentifier());
+  // Calls not matching the described signature are left to the conservative
+  // evaluation.
+  if (!Sig || Sig->getNumArgs() != CE->getNumArgs())
+    return false;
+
+  ProgramStateRef State = Ctx.getState();
+  const LocationContext *const LCtx = Ctx.getLocationContext();
+
+  // Invalidate the regions the MPI library may write to. In contrast to the
+  // conservative evaluation, globals and input arguments keep their values.
+  SmallVector<const MemRegion *, 4> OutRegions;
+  for (unsigned Idx = 0; Idx < CE->getNumArgs(); ++Idx) {
+    if (!Sig->isOutput(Idx))
+      continue;
+    if (const MemRegion *const MR =
+            State->getSVal(CE->getArg(Idx), LCtx).getAsRegion())
+      OutRegions.push_back(MR);
   }
-  const MemRegion *const MR =
-      PreCallEvent.getArgSVal(PreCallEvent.getNumArgs() - 1).getAsRegion();
-  if (!MR)
-    return;
+  if (!OutRegions.empty()) {
+    State = State->invalidateRegions(OutRegions, CE, Ctx.blockCount(), LCtx,
+                                     /*CausesPointerEscape=*/true);
+  }
+
+  State = bindRankAndSize(CE, *Sig, State, Ctx);
+  State = trackSynchronization(CE, *Sig, State, Ctx);
+  State = trackPointToPointOrder(CE, *Sig, State, Ctx);
+  State = trackFileViews(CE, *Sig, State, Ctx);
+
+  const QualType ResultTy = CE->getCallReturnType(Ctx.getASTContext());
+  if (!ResultTy->isVoidType()) {
+    const SVal RetVal = Ctx.getSValBuilder().conjureSymbolVal(
+        nullptr, CE, LCtx, ResultTy, Ctx.blockCount());
+    State = State->BindExpr(CE, LCtx, RetVal);
+  }
+
+  if (FuncClassifier->isTestType(FD->getIdentifier()) ||
+      FuncClassifier->isWaitSomeType(FD->getIdentifier())) {
+    evalCompletion(CE, *Sig, State, Ctx);
+    return true;
+  }
+
+  Ctx.addTransition(State);
+  return true;
+}
+
+void MPIChecker::checkLiveSymbols(ProgramStateRef State,
+                                  SymbolReaper &SymReaper) const {
+  for (const auto &Comm : State->get<CommunicatorMap>()) {
+    SymReaper.markLive(Comm.second.Size);
+    if (Comm.second.Rank)
+      SymReaper.markLive(Comm.second.Rank);
+  }
+
+  // Views refer to derived datatypes by their handle, and a closed file is
+  // only reported once its handle is used again. Both handles have to outlive
+  // their last use as long as their stack frame is active.
+  const LocationContext *const LCtx = SymReaper.getLocationContext();
+  for (const auto &Res : State->get<MPIResourceMap>()) {
+    const bool IsClosedFile =
+        Res.second.ResourceKind == MPIResource::File &&
+        Res.second.CurrentState == MPIResource::Close;
+    if (Res.second.ResourceKind != MPIResource::Datatype && !IsClosedFile)
+      continue;
+    const auto *const Stack =
+        dyn_cast<StackSpaceRegion>(Res.first->getMemorySpace());
+    const StackFrameContext *const Frame =
+        Stack ? Stack->getStackFrame() : nullptr;
+    if (!Frame || (LCtx && (Frame == LCtx || Frame->isParentOf(LCtx))))
+      SymReaper.markLive(Res.first);
+  }
+}
+
+/// Returns a key identifying the communicator or datatype a handle evaluates
+/// to, or nullptr if the handle is unknown. Integer constants are uniqued by
+/// the BasicValueFactory, so their address can serve as key.
+static const void *handleKey(SVal Handle) {
+  if (const MemRegion *const MR = Handle.getAsRegion())
+    return MR;
+  if (const SymbolRef Sym = Handle.getAsSymbol())
+    return Sym;
+  if (const auto CI = Handle.getAs<nonloc::ConcreteInt>())
+    return &CI->getValue();
+  if (const auto CI = Handle.getAs<loc::ConcreteInt>())
+    return &CI->getValue();
+  return nullptr;
+}
+
+ProgramStateRef
+MPIChecker::bindRankAndSize(const CallExpr *CE,
+                            const MPIFunctionClassifier::Signature &Sig,
+                            ProgramStateRef State, CheckerContext &Ctx) const {
+  const IdentifierInfo *const IdentInfo = Ctx.getCalleeIdentifier(CE);
+  const bool IsRank = FuncClassifier->isMPI_Comm_rank(IdentInfo);
+  if (!IsRank && !FuncClassifier->isMPI_Comm_size(IdentInfo))
+    return State;
+
+  const int CommIdx = Sig.getArgIndex(MPIFunctionClassifier::Comm);
+  const int OutIdx = Sig.getArgIndex(MPIFunctionClassifier::Out);
+  if (CommIdx < 0 || OutIdx < 0)
+    return State;
+
+  const LocationContext *const LCtx = Ctx.getLocationContext();
+  const SVal CommHandle = State->getSVal(CE->getArg(CommIdx), LCtx);
+  const void *const CommKey = handleKey(CommHandle);
+  const Optional<Loc> OutLoc =
+      State->getSVal(CE->getArg(OutIdx), LCtx).getAs<Loc>();
+  const QualType ValueTy = CE->getArg(OutIdx)->getType()->getPointeeType();
+  if (!CommKey || !OutLoc || ValueTy.isNull() || !ValueTy->isIntegerType())
+    return State;
+
+  SValBuilder &SVB = Ctx.getSValBuilder();
+  SymbolManager &SymMgr = SVB.getSymbolManager();
+  static int SizeTag, RankTag;
+
+  // Constrains the state by the comparison of a symbol with a value.
+  auto assumeComparison = [&](ProgramStateRef S, BinaryOperator::Opcode Op,
+                              SymbolRef Sym, SVal Val) -> ProgramStateRef {
+    const auto Cond =
+        SVB.evalBinOp(S, Op, nonloc::SymbolVal(Sym), Val,
+                      SVB.getConditionType())
+            .getAs<DefinedOrUnknownSVal>();
+    return Cond ? S->assume(*Cond, true) : S;
+  };
+
+  const Communicator *const Comm = State->get<CommunicatorMap>(CommKey);
+  SymbolRef Size = Comm ? Comm->Size : nullptr;
+  SymbolRef Rank = Comm ? Comm->Rank : nullptr;
+  ProgramStateRef NewState = State;
+
+  if (!Size) {
+    Size = SymMgr.conjureSymbol(CE, LCtx, ValueTy, Ctx.blockCount(), &SizeTag);
+    NewState = assumeComparison(NewState, BO_GE, Size,
+                                SVB.makeIntVal(1, ValueTy));
+  }
+  if (IsRank && !Rank && NewState) {
+    Rank = SymMgr.conjureSymbol(CE, LCtx, ValueTy, Ctx.blockCount(), &RankTag);
+    NewState = assumeComparison(NewState, BO_GE, Rank,
+                                SVB.makeIntVal(0, ValueTy));
+    if (NewState)
+      NewState = assumeComparison(NewState, BO_LT, Rank,
+                                  nonloc::SymbolVal(Size));
+  }
+  // The previous state already rules out this communicator layout.
+  if (!NewState)
+    return State;
+
+  NewState = NewState->set<CommunicatorMap>(
+      CommKey, Communicator(CommHandle, Size, Rank));
+  return NewState->bindLoc(*OutLoc, nonloc::SymbolVal(IsRank ? Rank : Size),
+                           LCtx);
+}
+
+/// Sets the resource stored in a region and keeps the index of base regions
+/// in sync.
+static ProgramStateRef setResource(ProgramStateRef State,
+                                   const MemRegion *const MR,
+                                   const MPIResource &Res) {
+  if (!State->get<MPIResourceMap>(MR)) {
+    const MemRegion *const Base = MR->getBaseRegion();
+    const unsigned *const Count = State->get<MPIResourceBaseMap>(Base);
+    State = State->set<MPIResourceBaseMap>(Base, Count ? *Count + 1 : 1);
+  }
+  return State->set<MPIResourceMap>(MR, Res);
+}
+
+/// Removes the resource stored in a region and keeps the index of base
+/// regions in sync.
+static ProgramStateRef removeResource(ProgramStateRef State,
+                                      const MemRegion *const MR) {
+  if (!State->get<MPIResourceMap>(MR))
+    return State;
+  const MemRegion *const Base = MR->getBaseRegion();
+  const unsigned *const Count = State->get<MPIResourceBaseMap>(Base);
+  if (!Count || *Count <= 1)
+    State = State->remove<MPIResourceBaseMap>(Base);
+  else
+    State = State->set<MPIResourceBaseMap>(Base, *Count - 1);
+  State = State->remove<NoOverlapRequestSet>(MR);
+  State = State->remove<PolledRequestSet>(MR);
+  return State->remove<MPIResourceMap>(MR);
+}
+
+/// Adds a transition to the state from the node the previous checks of a call
+/// ended in. The node is continued from as is, if the state did not change.
+static ExplodedNode *chainTransition(ProgramStateRef State, ExplodedNode *Pred,
+                                     CheckerContext &Ctx) {
+  return State == Pred->getState() ? Pred : Ctx.addTransition(State, Pred);
+}
+
+/// Requests are tracked if they reside in a typed region, or in an element of
+/// an array that is either typed or allocated on the heap.
+static bool isTrackableRequestRegion(const MemRegion *const MR) {
   const ElementRegion *const ER = dyn_cast<ElementRegion>(MR);
+  if (!ER)
+    return isa<TypedRegion>(MR);
 
+  const MemRegion *const SuperRegion = ER->getSuperRegion();
+  return isa<TypedRegion>(SuperRegion) ||
+         (isa<SymbolicRegion>(SuperRegion) &&
+          isa<HeapSpaceRegion>(SuperRegion->getMemorySpace()));
+}
+
+/// Returns the array a region passed as array of requests belongs to, or
+/// nullptr if a single request is passed. Arrays decay to their first
+/// element, heap allocated arrays are passed as the symbolic region of the
+/// allocation.
+static const MemRegion *requestArrayRegion(const MemRegion *const MR) {
+  if (const ElementRegion *const ER = MR->getAs<ElementRegion>())
+    return isTrackableRequestRegion(ER) ? ER->getSuperRegion() : nullptr;
+  if (isa<SymbolicRegion>(MR) && isa<HeapSpaceRegion>(MR->getMemorySpace()))
+    return MR;
+  return nullptr;
+}
+
+/// Completes a tracked request. Nonblocking requests are waited for, active
+/// persistent requests become inactive and can be started again.
+static ProgramStateRef completeRequest(ProgramStateRef State,
+                                       const MemRegion *const MR,
+                                       const MPIResource &Req,
+                                       const Expr *const Origin) {
+  if (Req.ResourceKind == MPIResource::PersistentRequest) {
+    if (Req.CurrentState != MPIResource::Active)
+      return State;
+    return setResource(State, MR,
+                       MPIResource(MPIResource::PersistentRequest,
+                                   MPIResource::Inactive, Origin));
+  }
+  if (Req.ResourceKind != MPIResource::Request ||
+      Req.CurrentState == MPIResource::Wait)
+    return State;
+  return setResource(
+      State, MR, MPIResource(MPIResource::Request, MPIResource::Wait, Origin));
+}
+
+ExplodedNode *
+MPIChecker::checkDoubleNonblocking(const CallEvent &PreCallEvent,
+                                   ExplodedNode *Pred,
+                                   CheckerContext &Ctx) const {
+  if (!FuncClassifier->isNonBlockingType(PreCallEvent.getCalleeIdentifier())) {
+    return Pred;
+  }
+  const MemRegion *const MR =
+      argRegion(PreCallEvent, MPIFunctionClassifier::Request);
   // The region must be typed, in order to reason about it.
-  if (!isa<TypedRegion>(MR) || (ER && !isa<TypedRegion>(ER->getSuperRegion())))
-    return;
+  if (!MR || !isTrackableRequestRegion(MR))
+    return Pred;
 
-  ProgramStateRef State = Ctx.getState();
-  const Request *const Req = State->get<RequestMap>(MR);
+  ProgramStateRef State = Pred->getState();
+  const MPIResource *const Req = State->get<MPIResourceMap>(MR);
 
   // double nonblocking detected
-  if (Req && Req->CurrentState == Request::State::Nonblocking) {
-    ExplodedNode *ErrorNode = Ctx.generateNonFatalErrorNode();
+  if (Req && Req->CurrentState == MPIResource::Nonblocking &&
+      ChecksEnabled[CK_MPIChecker]) {
+    static CheckerProgramPointTag Tag("MPI-Checker", "DoubleNonblocking");
+    ExplodedNode *const ErrorNode = Ctx.addTransition(State, Pred, &Tag);
+    if (!ErrorNode)
+      return nullptr;
     BReporter.reportDoubleNonblocking(PreCallEvent, *Req, MR, ErrorNode,
                                       Ctx.getBugReporter());
-    Ctx.addTransition(ErrorNode->getState(), ErrorNode);
+    return ErrorNode;
   }
   // no error
-  else {
-    State = State->set<RequestMap>(MR, Request::State::Nonblocking);
-    Ctx.addTransition(State);
-  }
+  State = setResource(State, MR,
+                      MPIResource(MPIResource::Request,
+                                  MPIResource::Nonblocking,
+                                  PreCallEvent.getOriginExpr()));
+  // The request waits for work to overlap with, until the next non-MPI
+  // call or store.
+  if (ChecksEnabled[CK_MPIPerformanceChecker])
+    State = State->add<NoOverlapRequestSet>(MR);
+  return chainTransition(State, Pred, Ctx);
 }
 
-void MPIChecker::checkDoubleClose(const CallEvent &PreCallEvent,
-                                  CheckerContext &Ctx) const {
-  // Get the CallEvent PreCallEvent(Path-sensitive callback) and check if there
-  // is Pointer to a valid Ident Info returned by isMPI_File_close
-  if (!FuncClassifier->isMPI_File_close(PreCallEvent.getCalleeIdentifier())) {
-    return;
-  }
-  // load the file on position NumArgs - 1 into MemRegion
+ExplodedNode *MPIChecker::checkDoubleClose(const CallEvent &PreCallEvent,
+                                           ExplodedNode *Pred,
+                                           CheckerContext &Ctx) const {
+  if (!FuncClassifier->isMPI_File_close(PreCallEvent.getCalleeIdentifier()))
+    return Pred;
   const MemRegion *const MR =
-      // or getArgSVal(0)
-      PreCallEvent.getArgSVal(PreCallEvent.getNumArgs() - 1).getAsRegion();
+      argRegion(PreCallEvent, MPIFunctionClassifier::OutFile);
   if (!MR)
-    return;
+    return Pred;
   const ElementRegion *const ER = dyn_cast<ElementRegion>(MR);
-  // something wrong with the type?
   if (!isa<TypedRegion>(MR) || (ER && !isa<TypedRegion>(ER->getSuperRegion())))
-    return;
-  /* get actual Ctx (CheckerContext structure) as programstate
-    this will have information for the begugging message and many more
-    ProgramState holds complete information on a momentary state of the program
-    under analysis New State needs to be created, because the original ones are
-    immutable*/
-  ProgramStateRef State = Ctx.getState();
-  const MPIFile *const Fh = State->get<MPIFileMap>(MR);
-
-  // create ErrorNode
-  // if FH and Fh is already stored in the MPIFileMap(MR)
-  if (Fh && Fh->CurrentState == MPIFile::State::Close) {
-    // Ctx.generateNonFatalErrorNode()
-    // This node will not be a sink. That is, exploration will continue along
-    // this path.
-    ExplodedNode *ErrorNode = Ctx.generateNonFatalErrorNode();
+    return Pred;
+
+  ProgramStateRef State = Pred->getState();
+  const MPIResource *const Fh = State->get<MPIResourceMap>(MR);
+
+  if (Fh && Fh->CurrentState == MPIResource::Close &&
+      ChecksEnabled[CK_MPIChecker]) {
+    static CheckerProgramPointTag Tag("MPI-Checker", "DoubleClose");
+    ExplodedNode *const ErrorNode = Ctx.addTransition(State, Pred, &Tag);
+    if (!ErrorNode)
+      return nullptr;
     BReporter.reportDoubleClose(PreCallEvent, *Fh, MR, ErrorNode,
                                 Ctx.getBugReporter());
-    Ctx.addTransition(ErrorNode->getState(), ErrorNode);
-  }
-  // no error continue
-  else {
-    // obtain a new state with a modified trait value
-    // trait was defined in MPITypes_2.h
-    // through set a new state is obtained, but with modified trait value
-    State = State->set<MPIFileMap>(MR, MPIFile::State::Close);
-    // add new modified State
-    Ctx.addTransition(State);
+    return ErrorNode;
   }
+  // no error
+  State = setResource(State, MR,
+                      MPIResource(MPIResource::File, MPIResource::Close,
+                                  PreCallEvent.getOriginExpr()));
+  return chainTransition(State, Pred, Ctx);
 }
 
-// in progress
-void MPIChecker::checkMissingClose(SymbolReaper &SymReaper,
-                                   CheckerContext &Ctx) const {
-  if (!SymReaper.hasDeadSymbols())
-    return;
+ExplodedNode *MPIChecker::checkDoubleOpen(const CallEvent &PreCallEvent,
+                                          ExplodedNode *Pred,
+                                          CheckerContext &Ctx) const {
+  if (!FuncClassifier->isMPI_File_open(PreCallEvent.getCalleeIdentifier()))
+    return Pred;
+  const MemRegion *const MR =
+      argRegion(PreCallEvent, MPIFunctionClassifier::OutFile);
+  if (!MR)
+    return Pred;
+  const ElementRegion *const ER = dyn_cast<ElementRegion>(MR);
+  if (!isa<TypedRegion>(MR) || (ER && !isa<TypedRegion>(ER->getSuperRegion())))
+    return Pred;
 
-  ProgramStateRef State = Ctx.getState();
-  const auto &MPIFiles = State->get<MPIFileMap>();
-  // still empty - nothing in MPIFiles
-  if (MPIFiles.isEmpty())
-    return;
+  ProgramStateRef State = Pred->getState();
+  const MPIResource *const Fh = State->get<MPIResourceMap>(MR);
 
-  static CheckerProgramPointTag Tag("MPI-Checker", "File Leak");
-  ExplodedNode *ErrorNode{nullptr};
+  if (Fh && Fh->CurrentState == MPIResource::Open &&
+      ChecksEnabled[CK_MPIChecker]) {
+    static CheckerProgramPointTag Tag("MPI-Checker", "DoubleOpen");
+    ExplodedNode *const ErrorNode = Ctx.addTransition(State, Pred, &Tag);
+    if (!ErrorNode)
+      return nullptr;
+    BReporter.reportDoubleOpen(PreCallEvent, *Fh, MR, ErrorNode,
+                               Ctx.getBugReporter());
+    return ErrorNode;
+  }
+  // no error
+  State = setResource(State, MR,
+                      MPIResource(MPIResource::File, MPIResource::Open,
+                                  PreCallEvent.getOriginExpr()));
+  return chainTransition(State, Pred, Ctx);
+}
 
-  auto FileMap = State->get<MPIFileMap>();
-  for (const auto &Fh : FileMap) {
-    if (!SymReaper.isLiveRegion(Fh.first)) {
-      printf("true \n");
-      // if Open is not alive and the file keeps being open
-      if (Fh.second.CurrentState == MPIFile::State::Open) {
-      printf("true2 \n");
-        if (!ErrorNode) {
-          ErrorNode = Ctx.generateNonFatalErrorNode(State, &Tag);
-          State = ErrorNode->getState();
-        }
-        BReporter.reportFileLeak(Fh.second, Fh.first, ErrorNode,
+/// Returns the region of the variable a file handle passed by value is read
+/// from, or nullptr if it is not read from a variable.
+static const MemRegion *fileRegion(const Expr *Arg, ProgramStateRef State,
+                                   const LocationContext *LCtx) {
+  const auto *Ref = dyn_cast<DeclRefExpr>(Arg->IgnoreParenImpCasts());
+  const auto *Var = Ref ? dyn_cast<VarDecl>(Ref->getDecl()) : nullptr;
+  return Var ? State->getLValue(Var, LCtx).getAsRegion() : nullptr;
+}
+
+ExplodedNode *MPIChecker::checkFileAccess(const CallEvent &PreCallEvent,
+                                          ExplodedNode *Pred,
+                                          CheckerContext &Ctx) const {
+  if (!ChecksEnabled[CK_MPIChecker])
+    return Pred;
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier->getSignature(PreCallEvent.getCalleeIdentifier());
+  if (!Sig || Sig->getNumArgs() != PreCallEvent.getNumArgs())
+    return Pred;
+  const int FileIdx = Sig->getArgIndex(MPIFunctionClassifier::File);
+  if (FileIdx < 0)
+    return Pred;
+
+  ProgramStateRef State = Pred->getState();
+  const MemRegion *const MR = fileRegion(PreCallEvent.getArgExpr(FileIdx),
+                                         State, Ctx.getLocationContext());
+  if (!MR)
+    return Pred;
+
+  // Handles without a tracked state were opened outside of the analyzed
+  // code, unless they were never initialized.
+  const MPIResource *const Fh = State->get<MPIResourceMap>(MR);
+  const bool IsClosed = Fh && Fh->ResourceKind == MPIResource::File &&
+                        Fh->CurrentState == MPIResource::Close;
+  const bool IsUnopened = !Fh && PreCallEvent.getArgSVal(FileIdx).isUndef();
+  if (!IsClosed && !IsUnopened)
+    return Pred;
+
+  static CheckerProgramPointTag Tag("MPI-Checker", "FileAccess");
+  ExplodedNode *const ErrorNode = Ctx.addTransition(State, Pred, &Tag);
+  if (!ErrorNode)
+    return nullptr;
+  if (IsClosed) {
+    BReporter.reportAccessAfterClose(PreCallEvent, MR, ErrorNode,
+                                     Ctx.getBugReporter());
+  } else {
+    BReporter.reportUnopenedFile(PreCallEvent, MR, ErrorNode,
                                  Ctx.getBugReporter());
-      }
-      // Remove the dead symbol from the MPIFileMap
-      State = State->remove<MPIFileMap>(Fh.first);
-    }
   }
-  // Transition to update the state regarding removed requests.
-  if (!ErrorNode) {
-    Ctx.addTransition(State);
-  } else {
-    Ctx.addTransition(State, ErrorNode);
+  return ErrorNode;
+}
+
+MPIChecker::DatatypeLayout
+MPIChecker::datatypeLayout(const Expr *Handle, SVal Value,
+                           ProgramStateRef State, CheckerContext &Ctx,
+                           unsigned Depth) const {
+  const DatatypeLayout Unknown{nullptr, true};
+  const LocationContext *const LCtx = Ctx.getLocationContext();
+  BasicValueFactory &BVF = Ctx.getSValBuilder().getBasicValueFactory();
+
+  // Predefined datatypes are integer constants or addresses of globals.
+  llvm::APSInt Constant;
+  if (Handle->EvaluateAsInt(Constant, Ctx.getASTContext()))
+    return {&BVF.getValue(Constant), true};
+  const Expr *const E = Handle->IgnoreParenCasts();
+  if (const auto *const Addr = dyn_cast<UnaryOperator>(E)) {
+    const auto *const Ref =
+        dyn_cast<DeclRefExpr>(Addr->getSubExpr()->IgnoreParenImpCasts());
+    const auto *const Global =
+        Ref ? dyn_cast<VarDecl>(Ref->getDecl()) : nullptr;
+    if (Addr->getOpcode() != UO_AddrOf || !Global ||
+        !Global->hasGlobalStorage())
+      return Unknown;
+    return {State->getLValue(Global, LCtx).getAsRegion(), true};
+  }
+
+  // Other handles are only resolved if they are stored in a variable.
+  const auto *const Ref = dyn_cast<DeclRefExpr>(E);
+  const auto *const Var = Ref ? dyn_cast<VarDecl>(Ref->getDecl()) : nullptr;
+  const MemRegion *const MR =
+      Var ? State->getLValue(Var, LCtx).getAsRegion() : nullptr;
+  const MPIResource *const Type =
+      MR ? State->get<MPIResourceMap>(MR) : nullptr;
+  if (!Type || Type->ResourceKind != MPIResource::Datatype) {
+    // The variable itself is no longer bound once it is dead.
+    if (MR && Value.isUnknownOrUndef())
+      Value = State->getSVal(loc::MemRegionVal(MR), Var->getType());
+    return Value.getAsSymbol() ? Unknown
+                               : DatatypeLayout{handleKey(Value), true};
   }
+
+  // Derived datatypes are resolved through the constructor that created
+  // them. The depth is limited, as a constructor may overwrite the handle of
+  // the datatype it is built from.
+  const auto *const Ctor = dyn_cast_or_null<CallExpr>(Type->Origin);
+  const FunctionDecl *const FD = Ctor ? Ctor->getDirectCallee() : nullptr;
+  const MPIFunctionClassifier::Signature *const Sig =
+      FD ? FuncClassifier->getSignature(FD->getIdentifier()) : nullptr;
+  const int OldIdx =
+      Sig ? Sig->getArgIndex(MPIFunctionClassifier::Datatype) : -1;
+  if (OldIdx < 0 || Depth >= 8)
+    return Unknown;
+  const DatatypeLayout Old = datatypeLayout(Ctor->getArg(OldIdx), UnknownVal(),
+                                            State, Ctx, Depth + 1);
+  return {Old.Element,
+          Old.IsContiguous &&
+              !FuncClassifier->isNoncontiguousType(FD->getIdentifier())};
 }
 
-// just for testing - tracks file open
-void MPIChecker::checkDoubleOpen(const CallEvent &PreCallEvent,
-                               CheckerContext &Ctx) const {
-  // if the Func Call is File_Open
-  if (!FuncClassifier->isMPI_File_open(PreCallEvent.getCalleeIdentifier())) {
-    return;
+ProgramStateRef MPIChecker::trackFileViews(
+    const CallExpr *CE, const MPIFunctionClassifier::Signature &Sig,
+    ProgramStateRef State, CheckerContext &Ctx) const {
+  const IdentifierInfo *const IdentInfo = Ctx.getCalleeIdentifier(CE);
+  const LocationContext *const LCtx = Ctx.getLocationContext();
+
+  // The view is recorded as origin of the open file, which is replaced once
+  // the file is closed or opened again.
+  if (FuncClassifier->isMPI_File_set_view(IdentInfo)) {
+    const int FileIdx = Sig.getArgIndex(MPIFunctionClassifier::File);
+    const MemRegion *const MR =
+        FileIdx < 0 ? nullptr : fileRegion(CE->getArg(FileIdx), State, LCtx);
+    const MPIResource *const Fh =
+        MR ? State->get<MPIResourceMap>(MR) : nullptr;
+    if (!Fh || Fh->ResourceKind != MPIResource::File ||
+        Fh->CurrentState != MPIResource::Open)
+      return State;
+    return setResource(State, MR,
+                       MPIResource(MPIResource::File, MPIResource::Open, CE));
   }
 
+  // Derived datatypes are tracked by the region of their handle, which is
+  // not changed by committing or using the datatype.
+  if (!FuncClassifier->isTypeConstructor(IdentInfo))
+    return State;
+  const int NewIdx = Sig.getArgIndex(MPIFunctionClassifier::OutDatatype);
   const MemRegion *const MR =
-      PreCallEvent.getArgSVal(PreCallEvent.getNumArgs() - 1).getAsRegion();
+      NewIdx < 0 ? nullptr
+                 : State->getSVal(CE->getArg(NewIdx), LCtx).getAsRegion();
   if (!MR)
+    return State;
+  return setResource(State, MR,
+                     MPIResource(MPIResource::Datatype, MPIResource::Open, CE));
+}
+
+ExplodedNode *MPIChecker::checkFileView(const CallEvent &PreCallEvent,
+                                        ExplodedNode *Pred,
+                                        CheckerContext &Ctx) const {
+  const IdentifierInfo *const IdentInfo = PreCallEvent.getCalleeIdentifier();
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier->getSignature(IdentInfo);
+  if (!Sig || !(Sig->Categories & MPIFunctionClassifier::IODataAccess) ||
+      Sig->getNumArgs() != PreCallEvent.getNumArgs())
+    return Pred;
+  const int FileIdx = Sig->getArgIndex(MPIFunctionClassifier::File);
+  const int DatatypeIdx = Sig->getArgIndex(MPIFunctionClassifier::Datatype);
+  if (FileIdx < 0 || DatatypeIdx < 0)
+    return Pred;
+
+  ProgramStateRef State = Pred->getState();
+  const MemRegion *const MR = fileRegion(PreCallEvent.getArgExpr(FileIdx),
+                                         State, Ctx.getLocationContext());
+  const MPIResource *const Fh = MR ? State->get<MPIResourceMap>(MR) : nullptr;
+  const auto *const View =
+      Fh && Fh->ResourceKind == MPIResource::File &&
+              Fh->CurrentState == MPIResource::Open
+          ? dyn_cast_or_null<CallExpr>(Fh->Origin)
+          : nullptr;
+  const FunctionDecl *const FD = View ? View->getDirectCallee() : nullptr;
+  if (!FD || !FuncClassifier->isMPI_File_set_view(FD->getIdentifier()))
+    return Pred;
+  const int ETypeIdx = FuncClassifier->getSignature(FD->getIdentifier())
+                           ->getArgIndex(MPIFunctionClassifier::Datatype);
+  if (ETypeIdx < 0 || static_cast<unsigned>(ETypeIdx) + 1 >= View->getNumArgs())
+    return Pred;
+
+  // Accesses have to be built from the etype of the view. Independent
+  // accesses through a noncontiguous filetype are split into many small
+  // requests, which only collective accesses can merge across processes.
+  // The datatypes of the view are resolved in the state of the access.
+  const void *const EType =
+      datatypeLayout(View->getArg(ETypeIdx), UnknownVal(), State, Ctx).Element;
+  const void *const Element =
+      datatypeLayout(PreCallEvent.getArgExpr(DatatypeIdx),
+                     PreCallEvent.getArgSVal(DatatypeIdx), State, Ctx)
+          .Element;
+  const bool IsMismatch =
+      ChecksEnabled[CK_MPIChecker] && EType && Element && Element != EType;
+  const bool IsIndependent =
+      ChecksEnabled[CK_MPIPerformanceChecker] &&
+      !datatypeLayout(View->getArg(ETypeIdx + 1), UnknownVal(), State, Ctx)
+           .IsContiguous &&
+      !FuncClassifier->isMPIIO_collective(IdentInfo);
+  if (!IsMismatch && !IsIndependent)
+    return Pred;
+
+  static CheckerProgramPointTag Tag("MPI-Checker", "FileView");
+  ExplodedNode *const ErrorNode = Ctx.addTransition(State, Pred, &Tag);
+  if (!ErrorNode)
+    return nullptr;
+  if (IsMismatch) {
+    BReporter.reportViewTypeMismatch(PreCallEvent, *View, MR, ErrorNode,
+                                     Ctx.getBugReporter());
+  }
+  if (IsIndependent) {
+    BReporter.reportNoncontiguousIndependentAccess(
+        CheckNames[CK_MPIPerformanceChecker], PreCallEvent, *View,
+        MPIFunctionClassifier::getCollectiveCounterpart(IdentInfo->getName()),
+        MR, ErrorNode, Ctx.getBugReporter());
+  }
+  return ErrorNode;
+}
+
+void MPIChecker::checkEndFunction(CheckerContext &Ctx) const {
+  if (!ChecksEnabled[CK_MPIChecker] || !Ctx.inTopFrame())
     return;
-  const ElementRegion *const ER = dyn_cast<ElementRegion>(MR);
-  // something wrong with the type?
-  if (!isa<TypedRegion>(MR) || (ER && !isa<TypedRegion>(ER->getSuperRegion())))
+
+  // Handles in local variables are reported once they are dead. Global
+  // handles may still be closed by the caller, unless the program ends.
+  const auto *FD = dyn_cast_or_null<FunctionDecl>(
+      Ctx.getLocationContext()->getDecl());
+  if (!FD || !FD->isMain())
     return;
-  // capture the next transition where the State is open
-  ProgramStateRef State = Ctx.getState();
 
-  const MPIFile *const Fh = State->get<MPIFileMap>(MR);
-  if(Fh && Fh->CurrentState == MPIFile::State::Open)
-  {
-    // not needed, just for testing
-    ExplodedNode *ErrorNode = Ctx.generateNonFatalErrorNode();
-    BReporter.reportDoubleOpen(PreCallEvent, *Fh, MR, ErrorNode,
-                                      Ctx.getBugReporter());
-    Ctx.addTransition(ErrorNode->getState(), ErrorNode);
-  }else {
-     // important to track File_open
-    State = State->set<MPIFileMap>(MR, MPIFile::State::Open);
-    Ctx.addTransition(State);
+  ProgramStateRef State = Ctx.getState();
+  static CheckerProgramPointTag Tag("MPI-Checker", "FileLeak");
+  ExplodedNode *ErrorNode{nullptr};
+  for (const auto &Res : State->get<MPIResourceMap>()) {
+    if (Res.second.ResourceKind != MPIResource::File ||
+        Res.second.CurrentState != MPIResource::Open)
+      continue;
+    if (!ErrorNode) {
+      ErrorNode = Ctx.generateNonFatalErrorNode(State, &Tag);
+      if (!ErrorNode)
+        return;
+    }
+    BReporter.reportFileLeak(Res.second, Res.first, ErrorNode,
+                             Ctx.getBugReporter());
   }
 }
 
-void MPIChecker::checkUnmatchedWaits(const CallEvent &PreCallEvent,
-                                     CheckerContext &Ctx) const {
+ExplodedNode *MPIChecker::checkUnmatchedWaits(const CallEvent &PreCallEvent,
+                                              ExplodedNode *Pred,
+                                              CheckerContext &Ctx) const {
   if (!FuncClassifier->isWaitType(PreCallEvent.getCalleeIdentifier()))
-    return;
+    return Pred;
   const MemRegion *const MR = topRegionUsedByWait(PreCallEvent);
   if (!MR)
-    return;
-  const ElementRegion *const ER = dyn_cast<ElementRegion>(MR);
+    return Pred;
 
-  // The region must be typed, in order to reason about it.
-  if (!isa<TypedRegion>(MR) || (ER && !isa<TypedRegion>(ER->getSuperRegion())))
+  ProgramStateRef State = Pred->getState();
+  llvm::SmallVector<const MemRegion *, 2> UnmatchedRegions;
+  const MemRegion *NoOverlapRegion = nullptr;
+
+  // A request array passed to MPI_Waitall is completed as a whole.
+  if (const MemRegion *const ArrayRegion =
+          requestArrayUsedByWait(PreCallEvent, MR)) {
+    State = completeRequestArray(ArrayRegion, PreCallEvent, State,
+                                 UnmatchedRegions, Ctx);
+  } else {
+    // The region must be typed, in order to reason about it.
+    if (!isTrackableRequestRegion(MR))
+      return Pred;
+    const MPIResource *const Req = requestState(State, MR);
+    if (!Req)
+      UnmatchedRegions.push_back(MR);
+    else if (Req->CurrentState == MPIResource::Nonblocking &&
+             State->contains<NoOverlapRequestSet>(MR))
+      NoOverlapRegion = MR;
+    State = State->remove<NoOverlapRequestSet>(MR);
+    if (Req && Req->ResourceKind == MPIResource::PersistentRequest) {
+      // A completed persistent request becomes inactive and can be started
+      // again.
+      if (Req->CurrentState == MPIResource::Active) {
+        State = setResource(State, MR,
+                            MPIResource(MPIResource::PersistentRequest,
+                                        MPIResource::Inactive,
+                                        PreCallEvent.getOriginExpr()));
+      }
+    }
+    // Waiting for a completed request does not change its state.
+    else if (!Req || Req->CurrentState != MPIResource::Wait) {
+      State = setResource(State, MR,
+                          MPIResource(MPIResource::Request, MPIResource::Wait,
+                                      PreCallEvent.getOriginExpr()));
+    }
+  }
+
+  // The wait directly follows the nonblocking call of the request. The report
+  // is attached to the state before the wait, so that the nonblocking call
+  // is found by the path notes.
+  if (NoOverlapRegion && ChecksEnabled[CK_MPIPerformanceChecker]) {
+    static CheckerProgramPointTag NoOverlapTag("MPI-Checker", "NoOverlap");
+    Pred = Ctx.addTransition(Pred->getState(), Pred, &NoOverlapTag);
+    if (!Pred)
+      return nullptr;
+    BReporter.reportNoOverlap(CheckNames[CK_MPIPerformanceChecker],
+                              PreCallEvent, NoOverlapRegion, Pred,
+                              Ctx.getBugReporter());
+  }
+
+  if (UnmatchedRegions.empty() || !ChecksEnabled[CK_MPIChecker])
+    return chainTransition(State, Pred, Ctx);
+
+  // A wait has no matching nonblocking call.
+  static CheckerProgramPointTag Tag("MPI-Checker", "UnmatchedWait");
+  ExplodedNode *const ErrorNode = Ctx.addTransition(State, Pred, &Tag);
+  if (!ErrorNode)
+    return nullptr;
+  for (const MemRegion *const ReqRegion : UnmatchedRegions) {
+    BReporter.reportUnmatchedWait(PreCallEvent, ReqRegion, ErrorNode,
+                                  Ctx.getBugReporter());
+  }
+  return ErrorNode;
+}
+
+/// Removes the communicators whose handle is dead. Their symbolic size and
+/// rank are no longer kept alive afterwards.
+static ProgramStateRef removeDeadCommunicators(ProgramStateRef State,
+                                               SymbolReaper &SymReaper) {
+  for (const auto &Comm : State->get<CommunicatorMap>()) {
+    const SVal Handle = Comm.second.Handle;
+    bool IsDead = false;
+    if (const MemRegion *const MR = Handle.getAsRegion())
+      IsDead = !SymReaper.isLiveRegion(MR);
+    else if (const SymbolRef Sym = Handle.getAsSymbol())
+      IsDead = SymReaper.isDead(Sym);
+    if (IsDead)
+      State = State->remove<CommunicatorMap>(Comm.first);
+  }
+  return State;
+}
+
+void MPIChecker::checkDeadResources(SymbolReaper &SymReaper,
+                                    CheckerContext &Ctx) const {
+  if (!SymReaper.hasDeadSymbols())
     return;
 
-  llvm::SmallVector<const MemRegion *, 2> ReqRegions;
-  allRegionsUsedByWait(ReqRegions, MR, PreCallEvent, Ctx);
-  if (ReqRegions.empty())
+  ProgramStateRef State = removeDeadCommunicators(Ctx.getState(), SymReaper);
+  bool IsAnyRemoved = State != Ctx.getState();
+
+  // Only the base regions are checked for liveness, which is independent of
+  // the number of resources stored in them.
+  llvm::SmallPtrSet<const MemRegion *, 4> DeadBases;
+  for (const auto &Base : State->get<MPIResourceBaseMap>()) {
+    if (!SymReaper.isLiveRegion(Base.first))
+      DeadBases.insert(Base.first);
+  }
+  if (DeadBases.empty()) {
+    if (IsAnyRemoved)
+      Ctx.addTransition(State);
     return;
+  }
 
-  ProgramStateRef State = Ctx.getState();
-  static CheckerProgramPointTag Tag("MPI-Checker", "UnmatchedWait");
+  static CheckerProgramPointTag Tag("MPI-Checker", "MissingRelease");
   ExplodedNode *ErrorNode{nullptr};
 
-  // Check all request regions used by the wait function.
-  for (const auto &ReqRegion : ReqRegions) {
-    const Request *const Req = State->get<RequestMap>(ReqRegion);
-    State = State->set<RequestMap>(ReqRegion, Request::State::Wait);
-    if (!Req) {
+  const auto Resources = State->get<MPIResourceMap>();
+  for (const auto &Res : Resources) {
+    if (!DeadBases.count(Res.first->getBaseRegion()) ||
+        SymReaper.isLiveRegion(Res.first))
+      continue;
+
+    const bool IsMissingWait =
+        Res.second.ResourceKind == MPIResource::Request &&
+        Res.second.CurrentState == MPIResource::Nonblocking;
+    const bool IsFileLeak = Res.second.ResourceKind == MPIResource::File &&
+                            Res.second.CurrentState == MPIResource::Open;
+    const bool IsRequestLeak =
+        Res.second.ResourceKind == MPIResource::PersistentRequest;
+    if ((IsMissingWait || IsFileLeak || IsRequestLeak) &&
+        ChecksEnabled[CK_MPIChecker]) {
       if (!ErrorNode) {
         ErrorNode = Ctx.generateNonFatalErrorNode(State, &Tag);
+        if (!ErrorNode)
+          return;
         State = ErrorNode->getState();
       }
-      // A wait has no matching nonblocking call.
-      BReporter.reportUnmatchedWait(PreCallEvent, ReqRegion, ErrorNode,
+      if (IsMissingWait) {
+        BReporter.reportMissingWait(Res.second, Res.first, ErrorNode,
                                     Ctx.getBugReporter());
+      } else if (IsRequestLeak) {
+        BReporter.reportPersistentRequestLeak(Res.second, Res.first,
+                                              ErrorNode,
+                                              Ctx.getBugReporter());
+      } else {
+        BReporter.reportFileLeak(Res.second, Res.first, ErrorNode,
+                                 Ctx.getBugReporter());
+      }
     }
+    State = removeResource(State, Res.first);
+    IsAnyRemoved = true;
   }
 
+  // Transition to update the state regarding removed resources.
+  if (!IsAnyRemoved)
+    return;
   if (!ErrorNode) {
     Ctx.addTransition(State);
   } else {
@@ -220,96 +774,703 @@ void MPIChecker::checkUnmatchedWaits(const CallEvent &PreCallEvent,
   }
 }
 
-void MPIChecker::checkMissingWaits(SymbolReaper &SymReaper,
-                                   CheckerContext &Ctx) const {
-  if (!SymReaper.hasDeadSymbols())
+ExplodedNode *
+MPIChecker::checkPersistentRequests(const CallEvent &PreCallEvent,
+                                    ExplodedNode *Pred,
+                                    CheckerContext &Ctx) const {
+  const IdentifierInfo *const IdentInfo = PreCallEvent.getCalleeIdentifier();
+  ProgramStateRef State = Pred->getState();
+
+  // A persistent request is created inactive.
+  if (FuncClassifier->isPersistentInit(IdentInfo)) {
+    const MemRegion *const MR =
+        argRegion(PreCallEvent, MPIFunctionClassifier::Request);
+    if (!MR || !isTrackableRequestRegion(MR))
+      return Pred;
+    return chainTransition(
+        setResource(State, MR, MPIResource(MPIResource::PersistentRequest,
+                                           MPIResource::Inactive,
+                                           PreCallEvent.getOriginExpr())),
+        Pred, Ctx);
+  }
+
+  // A freed request is no longer tracked.
+  if (FuncClassifier->isMPI_Request_free(IdentInfo)) {
+    const MemRegion *const MR =
+        argRegion(PreCallEvent, MPIFunctionClassifier::Request);
+    if (!MR)
+      return Pred;
+    return chainTransition(removeResource(State, MR), Pred, Ctx);
+  }
+
+  llvm::SmallVector<const MemRegion *, 2> StartedRegions;
+  if (FuncClassifier->isMPI_Start(IdentInfo)) {
+    if (const MemRegion *const MR =
+            argRegion(PreCallEvent, MPIFunctionClassifier::Request))
+      StartedRegions.push_back(MR);
+  } else if (FuncClassifier->isMPI_Startall(IdentInfo)) {
+    const MemRegion *const MR =
+        argRegion(PreCallEvent, MPIFunctionClassifier::Requests);
+    if (!MR)
+      return Pred;
+    const MemRegion *const ArrayRegion = requestArrayRegion(MR);
+    if (!ArrayRegion) {
+      StartedRegions.push_back(MR);
+    } else {
+      // Start the persistent requests tracked for elements of the array.
+      for (const auto &Req : State->get<MPIResourceMap>()) {
+        const ElementRegion *const ER = dyn_cast<ElementRegion>(Req.first);
+        if (ER && ER->getSuperRegion() == ArrayRegion)
+          StartedRegions.push_back(ER);
+      }
+    }
+  } else {
+    return Pred;
+  }
+
+  const MPIResource Activated(MPIResource::PersistentRequest,
+                              MPIResource::Active,
+                              PreCallEvent.getOriginExpr());
+  llvm::SmallVector<const MemRegion *, 2> DoubleStartedRegions;
+  for (const MemRegion *const MR : StartedRegions) {
+    const MPIResource *const Req = State->get<MPIResourceMap>(MR);
+    // Only requests known to be persistent are tracked.
+    if (!Req || Req->ResourceKind != MPIResource::PersistentRequest)
+      continue;
+    if (Req->CurrentState == MPIResource::Active)
+      DoubleStartedRegions.push_back(MR);
+    else
+      State = setResource(State, MR, Activated);
+  }
+
+  if (DoubleStartedRegions.empty() || !ChecksEnabled[CK_MPIChecker])
+    return chainTransition(State, Pred, Ctx);
+
+  // An active persistent request is started again.
+  static CheckerProgramPointTag Tag("MPI-Checker", "DoubleStart");
+  ExplodedNode *const ErrorNode = Ctx.addTransition(State, Pred, &Tag);
+  if (!ErrorNode)
+    return nullptr;
+  for (const MemRegion *const ReqRegion : DoubleStartedRegions) {
+    BReporter.reportDoubleStart(PreCallEvent, ReqRegion, ErrorNode,
+                                Ctx.getBugReporter());
+  }
+  return ErrorNode;
+}
+
+void MPIChecker::evalCompletion(const CallExpr *CE,
+                                const MPIFunctionClassifier::Signature &Sig,
+                                ProgramStateRef State,
+                                CheckerContext &Ctx) const {
+  const LocationContext *const LCtx = Ctx.getLocationContext();
+  const int ReqIdx = Sig.getArgIndex(MPIFunctionClassifier::Request);
+  const int ReqsIdx = Sig.getArgIndex(MPIFunctionClassifier::Requests);
+  if (ReqIdx < 0 && ReqsIdx < 0) {
+    Ctx.addTransition(State);
+    return;
+  }
+  const MemRegion *const MR =
+      State->getSVal(CE->getArg(ReqIdx >= 0 ? ReqIdx : ReqsIdx), LCtx)
+          .getAsRegion();
+  if (!MR) {
+    Ctx.addTransition(State);
     return;
+  }
 
-  ProgramStateRef State = Ctx.getState();
-  const auto &Requests = State->get<RequestMap>();
-  if (Requests.isEmpty())
+  // Completes the requests passed, a single one or the tracked requests of an
+  // array.
+  const MemRegion *const ArrayRegion =
+      ReqsIdx >= 0 ? requestArrayRegion(MR) : nullptr;
+  auto completeRequests = [&](ProgramStateRef S) {
+    S = S->remove<PolledRequestSet>(MR);
+    if (!ArrayRegion) {
+      const MPIResource *const Req = S->get<MPIResourceMap>(MR);
+      return Req ? completeRequest(S, MR, *Req, CE) : S;
+    }
+    const auto Resources = S->get<MPIResourceMap>();
+    for (const auto &Req : Resources) {
+      const ElementRegion *const ER = dyn_cast<ElementRegion>(Req.first);
+      if (Req.first == ArrayRegion ||
+          (ER && ER->getSuperRegion() == ArrayRegion))
+        S = completeRequest(S, Req.first, Req.second, CE);
+    }
+    return S;
+  };
+
+  // MPI_Testsome has no flag, the requests complete if the count of completed
+  // requests is not zero. A count of MPI_UNDEFINED means that no request was
+  // active. Without either, the requests are assumed to complete.
+  int FlagIdx = Sig.getArgIndex(MPIFunctionClassifier::Flag);
+  if (FlagIdx < 0 && (Sig.Categories & MPIFunctionClassifier::Test))
+    FlagIdx = Sig.getArgIndex(MPIFunctionClassifier::Out);
+  const Optional<Loc> FlagLoc =
+      FlagIdx >= 0 ? State->getSVal(CE->getArg(FlagIdx), LCtx).getAs<Loc>()
+                   : None;
+  const QualType FlagTy =
+      FlagIdx >= 0 ? CE->getArg(FlagIdx)->getType()->getPointeeType()
+                   : QualType();
+  const Optional<DefinedOrUnknownSVal> Flag =
+      FlagLoc && !FlagTy.isNull()
+          ? State->getSVal(*FlagLoc, FlagTy).getAs<DefinedOrUnknownSVal>()
+          : None;
+  if (!Flag) {
+    Ctx.addTransition(completeRequests(State));
     return;
+  }
 
-  static CheckerProgramPointTag Tag("MPI-Checker", "MissingWait");
-  ExplodedNode *ErrorNode{nullptr};
+  ProgramStateRef Completed, Pending;
+  std::tie(Completed, Pending) = State->assume(*Flag);
+  if (Completed)
+    Ctx.addTransition(completeRequests(Completed));
+  if (Pending) {
+    if (ChecksEnabled[CK_MPIPerformanceChecker])
+      Pending = Pending->add<PolledRequestSet>(MR);
+    Ctx.addTransition(Pending);
+  }
+}
 
-  auto ReqMap = State->get<RequestMap>();
-  for (const auto &Req : ReqMap) {
-    if (!SymReaper.isLiveRegion(Req.first)) {
-      if (Req.second.CurrentState == Request::State::Nonblocking) {
+ExplodedNode *MPIChecker::checkSpinningTest(const CallEvent &PreCallEvent,
+                                            ExplodedNode *Pred,
+                                            CheckerContext &Ctx) const {
+  if (!ChecksEnabled[CK_MPIPerformanceChecker] ||
+      !FuncClassifier->isTestType(PreCallEvent.getCalleeIdentifier()))
+    return Pred;
+  const MemRegion *MR =
+      argRegion(PreCallEvent, MPIFunctionClassifier::Request);
+  if (!MR)
+    MR = argRegion(PreCallEvent, MPIFunctionClassifier::Requests);
+  if (!MR || !Pred->getState()->contains<PolledRequestSet>(MR))
+    return Pred;
 
-        if (!ErrorNode) {
-          ErrorNode = Ctx.generateNonFatalErrorNode(State, &Tag);
-          State = ErrorNode->getState();
-        }
-        BReporter.reportMissingWait(Req.second, Req.first, ErrorNode,
-                                    Ctx.getBugReporter());
+  // The previous test did not complete the requests and nothing was done
+  // since.
+  static CheckerProgramPointTag Tag("MPI-Checker", "SpinningTest");
+  ExplodedNode *const ErrorNode =
+      Ctx.addTransition(Pred->getState(), Pred, &Tag);
+  if (!ErrorNode)
+    return nullptr;
+  BReporter.reportSpinningTest(CheckNames[CK_MPIPerformanceChecker],
+                               PreCallEvent, MR, ErrorNode,
+                               Ctx.getBugReporter());
+  return ErrorNode;
+}
+
+bool MPIChecker::isSynchronizing(const IdentifierInfo *const IdentInfo) const {
+  // Rooted collectives, scans and neighborhood collectives let processes
+  // leave before all others entered.
+  const uint64_t Categories = FuncClassifier->getCategories(IdentInfo);
+  if (!(Categories & MPIFunctionClassifier::Collective) ||
+      (Categories & MPIFunctionClassifier::NonBlocking))
+    return false;
+  return (Categories & MPIFunctionClassifier::Barrier) ||
+         ((Categories & MPIFunctionClassifier::CollToColl) &&
+          (Categories &
+           (MPIFunctionClassifier::Allgather | MPIFunctionClassifier::Alltoall |
+            MPIFunctionClassifier::Reduce)));
+}
+
+ProgramStateRef MPIChecker::trackSynchronization(
+    const CallExpr *CE, const MPIFunctionClassifier::Signature &Sig,
+    ProgramStateRef State, CheckerContext &Ctx) const {
+  if (!ChecksEnabled[CK_MPIPerformanceChecker])
+    return State;
+  const FunctionDecl *const FD = Ctx.getCalleeDecl(CE);
+  const int CommIdx = Sig.getArgIndex(MPIFunctionClassifier::Comm);
+  if (!FD || !isSynchronizing(FD->getIdentifier()) || CommIdx < 0)
+    return State->remove<SynchronizedCommMap>();
+
+  // A collective on another communicator is an MPI call between the earlier
+  // synchronizations and the next one.
+  State = State->remove<SynchronizedCommMap>();
+  const void *const CommKey = handleKey(
+      State->getSVal(CE->getArg(CommIdx), Ctx.getLocationContext()));
+  if (!CommKey)
+    return State;
+  return State->set<SynchronizedCommMap>(CommKey, CE);
+}
+
+/// Returns true if the statement is part of a loop body or condition.
+static bool isInLoop(const Stmt *S, const ParentMap &PM) {
+  for (const Stmt *Parent = PM.getParent(S); Parent;
+       Parent = PM.getParent(Parent)) {
+    if (isa<ForStmt>(Parent) || isa<WhileStmt>(Parent) || isa<DoStmt>(Parent) ||
+        isa<CXXForRangeStmt>(Parent))
+      return true;
+  }
+  return false;
+}
+
+ExplodedNode *
+MPIChecker::checkRedundantBarrier(const CallEvent &PreCallEvent,
+                                  ExplodedNode *Pred,
+                                  CheckerContext &Ctx) const {
+  if (!ChecksEnabled[CK_MPIPerformanceChecker] ||
+      !isSynchronizing(PreCallEvent.getCalleeIdentifier()))
+    return Pred;
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier->getSignature(PreCallEvent.getCalleeIdentifier());
+  const int CommIdx = Sig->getArgIndex(MPIFunctionClassifier::Comm);
+  if (CommIdx < 0 ||
+      static_cast<unsigned>(CommIdx) >= PreCallEvent.getNumArgs())
+    return Pred;
+  const void *const CommKey =
+      handleKey(PreCallEvent.getArgSVal(CommIdx));
+  const CallExpr *const *const Previous =
+      CommKey ? Pred->getState()->get<SynchronizedCommMap>(CommKey) : nullptr;
+  if (!Previous)
+    return Pred;
+
+  // Two adjacent synchronizing collectives are fine, unless one of them only
+  // synchronizes.
+  const FunctionDecl *const PreviousFD = (*Previous)->getDirectCallee();
+  const bool IsBarrier =
+      FuncClassifier->isMPI_Barrier(PreCallEvent.getCalleeIdentifier());
+  const bool IsPreviousBarrier =
+      PreviousFD && FuncClassifier->isMPI_Barrier(PreviousFD->getIdentifier());
+  if (!IsBarrier && !IsPreviousBarrier)
+    return Pred;
+
+  static CheckerProgramPointTag Tag("MPI-Checker", "RedundantBarrier");
+  ExplodedNode *const ErrorNode =
+      Ctx.addTransition(Pred->getState(), Pred, &Tag);
+  if (!ErrorNode)
+    return nullptr;
+  const Stmt *const Barrier =
+      IsBarrier ? PreCallEvent.getOriginExpr() : *Previous;
+  BReporter.reportRedundantBarrier(
+      CheckNames[CK_MPIPerformanceChecker], PreCallEvent, **Previous,
+      IsBarrier, Barrier && isInLoop(Barrier, Ctx.getLocationContext()
+                                                  ->getParentMap()),
+      ErrorNode, Ctx.getBugReporter());
+  return ErrorNode;
+}
+
+/// Returns the name of the nonblocking variant of a blocking collective, like
+/// MPI_Iallreduce for MPI_Allreduce.
+static std::string nonblockingCollectiveName(const CallExpr *const CE) {
+  const FunctionDecl *const FD = CE->getDirectCallee();
+  if (!FD || !FD->getName().startswith("MPI_"))
+    return "";
+  return "MPI_I" + FD->getName().drop_front(4).lower();
+}
+
+void MPIChecker::checkPendingCollectives(const CallEvent &PostCallEvent,
+                                         CheckerContext &Ctx) const {
+  if (!ChecksEnabled[CK_MPIPerformanceChecker])
+    return;
+  ProgramStateRef State = Ctx.getState();
+  ExplodedNode *ErrorNode = nullptr;
+  const IdentifierInfo *const IdentInfo = PostCallEvent.getCalleeIdentifier();
+
+  // The call of a non-MPI function taking the buffer was counted as work by
+  // checkPreCall, but cannot overlap the collective.
+  if (!State->get<PendingCollectiveMap>().isEmpty()) {
+    const unsigned UncountedWork = FuncClassifier->isMPIType(IdentInfo) ? 0 : 1;
+    for (unsigned Idx = 0; Idx < PostCallEvent.getNumArgs(); ++Idx) {
+      if (const MemRegion *const MR =
+              PostCallEvent.getArgSVal(Idx).getAsRegion()) {
+        State = endPendingCollective(State, MR->getBaseRegion(),
+                                     /*IsLoad=*/false, UncountedWork,
+                                     ErrorNode, Ctx);
       }
-      State = State->remove<RequestMap>(Req.first);
     }
   }
 
-  // Transition to update the state regarding removed requests.
-  if (!ErrorNode) {
+  // Track blocking collectives with a nonblocking variant.
+  const auto *const CE =
+      dyn_cast_or_null<CallExpr>(PostCallEvent.getOriginExpr());
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier->getSignature(IdentInfo);
+  if (CE && Sig && FuncClassifier->isCollectiveType(IdentInfo) &&
+      !FuncClassifier->isNonBlockingType(IdentInfo) && Sig->hasBuffer() &&
+      FuncClassifier->isNonBlockingType(&Ctx.getASTContext().Idents.get(
+          nonblockingCollectiveName(CE)))) {
+    for (unsigned Idx = 0; Idx < PostCallEvent.getNumArgs(); ++Idx) {
+      const MemRegion *const MR = PostCallEvent.getArgSVal(Idx).getAsRegion();
+      if (!MR || !Sig->isBuffer(Idx))
+        continue;
+      // A buffer both sent and received counts as receive buffer.
+      const bool IsSendBuffer =
+          Sig->getRole(Idx) == MPIFunctionClassifier::SendBuf;
+      const PendingCollective *const Existing =
+          State->get<PendingCollectiveMap>(MR->getBaseRegion());
+      if (IsSendBuffer && Existing && Existing->Call == CE)
+        continue;
+      State = State->set<PendingCollectiveMap>(
+          MR->getBaseRegion(), PendingCollective(CE, 0, IsSendBuffer));
+    }
+  }
+
+  if (State == Ctx.getState())
+    return;
+  if (ErrorNode)
+    Ctx.addTransition(State, ErrorNode);
+  else
     Ctx.addTransition(State);
-  } else {
+}
+
+void MPIChecker::checkLocation(SVal Loc, bool IsLoad, const Stmt *S,
+                               CheckerContext &Ctx) const {
+  ProgramStateRef State = Ctx.getState();
+  const MemRegion *const MR = Loc.getAsRegion();
+  if (!MR || State->get<PendingCollectiveMap>().isEmpty())
+    return;
+
+  ExplodedNode *ErrorNode = nullptr;
+  State = endPendingCollective(State, MR->getBaseRegion(), IsLoad,
+                               /*UncountedWork=*/0, ErrorNode, Ctx);
+  if (State == Ctx.getState())
+    return;
+  if (ErrorNode)
     Ctx.addTransition(State, ErrorNode);
+  else
+    Ctx.addTransition(State);
+}
+
+ProgramStateRef MPIChecker::endPendingCollective(
+    ProgramStateRef State, const MemRegion *const Base, const bool IsLoad,
+    const unsigned UncountedWork, ExplodedNode *&ErrorNode,
+    CheckerContext &Ctx) const {
+  const PendingCollective *const Pending =
+      State->get<PendingCollectiveMap>(Base);
+  if (!Pending || (IsLoad && Pending->IsSendBuffer))
+    return State;
+
+  const CallExpr *const Collective = Pending->Call;
+  const unsigned Work =
+      Pending->Work - std::min(Pending->Work, UncountedWork);
+  const auto Collectives = State->get<PendingCollectiveMap>();
+  for (const auto &Buffer : Collectives) {
+    if (Buffer.second.Call == Collective)
+      State = State->remove<PendingCollectiveMap>(Buffer.first);
+  }
+  if (!Work)
+    return State;
+
+  static CheckerProgramPointTag Tag("MPI-Checker", "BlockingCollective");
+  if (!ErrorNode) {
+    ErrorNode = Ctx.generateNonFatalErrorNode(State, &Tag);
+    if (!ErrorNode)
+      return State;
+  }
+  BReporter.reportBlockingCollective(
+      CheckNames[CK_MPIPerformanceChecker], *Collective,
+      nonblockingCollectiveName(Collective), Work, ErrorNode,
+      Ctx.getBugReporter());
+  return State;
+}
+
+/// Returns the rank a peer argument evaluates to, if it is known and denotes
+/// a process. MPI_ANY_SOURCE and MPI_PROC_NULL are negative.
+static const llvm::APSInt *knownPeer(SVal Peer, ProgramStateRef State,
+                                     SValBuilder &SVB) {
+  const llvm::APSInt *const Rank = SVB.getKnownValue(State, Peer);
+  return Rank && !Rank->isNegative() ? Rank : nullptr;
+}
+
+ProgramStateRef MPIChecker::trackPointToPointOrder(
+    const CallExpr *CE, const MPIFunctionClassifier::Signature &Sig,
+    ProgramStateRef State, CheckerContext &Ctx) const {
+  if (!ChecksEnabled[CK_MPIPerformanceChecker] ||
+      !(Sig.Categories & MPIFunctionClassifier::PointToPoint))
+    return State;
+
+  // Any receive, blocking or not, is posted for all peers it names.
+  const bool IsReceive = Sig.getArgIndex(MPIFunctionClassifier::RecvBuf) >= 0;
+  for (unsigned Idx = 0; Idx < CE->getNumArgs(); ++Idx) {
+    if (Sig.getRole(Idx) != MPIFunctionClassifier::Peer)
+      continue;
+    const llvm::APSInt *const Peer =
+        knownPeer(State->getSVal(CE->getArg(Idx), Ctx.getLocationContext()),
+                  State, Ctx.getSValBuilder());
+    if (!Peer)
+      continue;
+    if (IsReceive) {
+      State = State->remove<PendingSendMap>(Peer);
+      State = State->add<ReceivedPeerSet>(Peer);
+      continue;
+    }
+
+    // Buffered sends complete locally, nonblocking and persistent sends let
+    // the receive be posted first.
+    const uint64_t NotBlocking = MPIFunctionClassifier::NonBlocking |
+                                 MPIFunctionClassifier::PersistentInit |
+                                 MPIFunctionClassifier::BufferedSend;
+    if (Sig.getArgIndex(MPIFunctionClassifier::SendBuf) < 0 ||
+        (Sig.Categories & NotBlocking) ||
+        State->contains<ReceivedPeerSet>(Peer) ||
+        State->get<PendingSendMap>(Peer))
+      continue;
+    State = State->set<PendingSendMap>(Peer, CE);
   }
+  return State;
+}
+
+ExplodedNode *MPIChecker::checkHeadToHeadSend(const CallEvent &PreCallEvent,
+                                              ExplodedNode *Pred,
+                                              CheckerContext &Ctx) const {
+  if (!ChecksEnabled[CK_MPIPerformanceChecker])
+    return Pred;
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier->getSignature(PreCallEvent.getCalleeIdentifier());
+  // Nonblocking and persistent receives do not block before completion.
+  const uint64_t NotBlocking = MPIFunctionClassifier::NonBlocking |
+                               MPIFunctionClassifier::PersistentInit |
+                               MPIFunctionClassifier::Start;
+  if (!Sig || !(Sig->Categories & MPIFunctionClassifier::PointToPoint) ||
+      (Sig->Categories & NotBlocking) ||
+      Sig->getArgIndex(MPIFunctionClassifier::RecvBuf) < 0 ||
+      Sig->getArgIndex(MPIFunctionClassifier::SendBuf) >= 0 ||
+      Sig->getNumArgs() != PreCallEvent.getNumArgs())
+    return Pred;
+
+  const int PeerIdx = Sig->getArgIndex(MPIFunctionClassifier::Peer);
+  const int CommIdx = Sig->getArgIndex(MPIFunctionClassifier::Comm);
+  if (PeerIdx < 0 || CommIdx < 0)
+    return Pred;
+  ProgramStateRef State = Pred->getState();
+  const llvm::APSInt *const Peer = knownPeer(
+      PreCallEvent.getArgSVal(PeerIdx), State, Ctx.getSValBuilder());
+  const CallExpr *const *const Send =
+      Peer ? State->get<PendingSendMap>(Peer) : nullptr;
+  if (!Send)
+    return Pred;
+
+  // The rank of the path is needed to find the path of the peer.
+  const void *const CommKey =
+      handleKey(PreCallEvent.getArgSVal(CommIdx));
+  const Communicator *const Comm =
+      CommKey ? State->get<CommunicatorMap>(CommKey) : nullptr;
+  if (!Comm || !Comm->Rank)
+    return Pred;
+
+  // Only the state is recorded, the exploded graph is not changed.
+  SendsBeforeReceives.push_back({State, Ctx.getLocationContext(), Comm->Rank,
+                                 Peer, *Send,
+                                 cast<CallExpr>(PreCallEvent.getOriginExpr())});
+  return Pred;
+}
+
+/// Returns true if the rank of the path can have the given value.
+static bool canHaveRank(ProgramStateRef State, SymbolRef Rank,
+                        const llvm::APSInt &Value, SValBuilder &SVB) {
+  const SVal IsRank = SVB.evalEQ(
+      State, nonloc::SymbolVal(Rank),
+      SVB.makeIntVal(SVB.getBasicValueFactory().Convert(Rank->getType(),
+                                                        Value)));
+  const Optional<DefinedOrUnknownSVal> Cond =
+      IsRank.getAs<DefinedOrUnknownSVal>();
+  return !Cond || State->assume(*Cond, true);
+}
+
+void MPIChecker::checkEndAnalysis(ExplodedGraph &G, BugReporter &BR,
+                                  ExprEngine &Eng) const {
+  // Two paths exchange head-to-head, if each can be taken by the process
+  // the other one sends to.
+  SValBuilder &SVB = Eng.getSValBuilder();
+  for (auto First = SendsBeforeReceives.begin(),
+            End = SendsBeforeReceives.end();
+       First != End; ++First) {
+    for (auto Second = std::next(First); Second != End; ++Second) {
+      if (First->Rank != Second->Rank || *First->Peer == *Second->Peer)
+        continue;
+      if (!canHaveRank(First->State, First->Rank, *Second->Peer, SVB) ||
+          !canHaveRank(Second->State, Second->Rank, *First->Peer, SVB))
+        continue;
+      // The exchange is reported once, at the path that sends first in the
+      // source, independent of the order the paths were explored in.
+      const bool FirstIsBefore =
+          BR.getSourceManager().isBeforeInTranslationUnit(
+              First->Send->getLocStart(), Second->Send->getLocStart());
+      const SendBeforeReceive &Reported = FirstIsBefore ? *First : *Second;
+      const SendBeforeReceive &Other = FirstIsBefore ? *Second : *First;
+      BReporter.reportHeadToHeadSend(CheckNames[CK_MPIPerformanceChecker],
+                                     *Reported.Send, *Other.Send,
+                                     *Reported.Recv, *Reported.Peer,
+                                     Reported.LCtx, BR);
+    }
+  }
+  SendsBeforeReceives.clear();
+}
+
+ExplodedNode *MPIChecker::checkOverlappingCall(const CallEvent &PreCallEvent,
+                                               ExplodedNode *Pred,
+                                               CheckerContext &Ctx) const {
+  if (FuncClassifier->isMPIType(PreCallEvent.getCalleeIdentifier()))
+    return Pred;
+  return markOverlappingWork(Pred, Ctx);
+}
+
+ExplodedNode *MPIChecker::markOverlappingWork(ExplodedNode *Pred,
+                                              CheckerContext &Ctx) const {
+  ProgramStateRef State = Pred->getState();
+  const auto Collectives = State->get<PendingCollectiveMap>();
+  if (State->get<NoOverlapRequestSet>().isEmpty() &&
+      State->get<PolledRequestSet>().isEmpty() &&
+      State->get<SynchronizedCommMap>().isEmpty() && Collectives.isEmpty())
+    return Pred;
+
+  State = State->remove<NoOverlapRequestSet>()
+              ->remove<PolledRequestSet>()
+              ->remove<SynchronizedCommMap>();
+  for (const auto &Buffer : Collectives) {
+    State = State->set<PendingCollectiveMap>(
+        Buffer.first,
+        PendingCollective(Buffer.second.Call, Buffer.second.Work + 1,
+                          Buffer.second.IsSendBuffer));
+  }
+  return chainTransition(State, Pred, Ctx);
 }
 
 const MemRegion *MPIChecker::topRegionUsedByWait(const CallEvent &CE) const {
 
   if (FuncClassifier->isMPI_Wait(CE.getCalleeIdentifier())) {
-    return CE.getArgSVal(0).getAsRegion();
+    return argRegion(CE, MPIFunctionClassifier::Request);
   } else if (FuncClassifier->isMPI_Waitall(CE.getCalleeIdentifier())) {
-    return CE.getArgSVal(1).getAsRegion();
+    return argRegion(CE, MPIFunctionClassifier::Requests);
   } else {
     return (const MemRegion *)nullptr;
   }
 }
 
-void MPIChecker::allRegionsUsedByWait(
-    llvm::SmallVector<const MemRegion *, 2> &ReqRegions,
-    const MemRegion *const MR, const CallEvent &CE, CheckerContext &Ctx) const {
+const MemRegion *
+MPIChecker::argRegion(const CallEvent &CE,
+                      MPIFunctionClassifier::ArgRole Role) const {
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier->getSignature(CE.getCalleeIdentifier());
+  if (!Sig)
+    return nullptr;
 
-  MemRegionManager *const RegionManager = MR->getMemRegionManager();
+  const int Idx = Sig->getArgIndex(Role);
+  if (Idx < 0 || static_cast<unsigned>(Idx) >= CE.getNumArgs())
+    return nullptr;
+  return CE.getArgSVal(Idx).getAsRegion();
+}
 
-  if (FuncClassifier->isMPI_Waitall(CE.getCalleeIdentifier())) {
-    const MemRegion *SuperRegion{nullptr};
-    if (const ElementRegion *const ER = MR->getAs<ElementRegion>()) {
-      SuperRegion = ER->getSuperRegion();
-    }
+const MPIResource *
+MPIChecker::requestState(ProgramStateRef State,
+                         const MemRegion *const MR) const {
+  if (const MPIResource *const Req = State->get<MPIResourceMap>(MR))
+    return Req;
 
-    // A single request is passed to MPI_Waitall.
-    if (!SuperRegion) {
-      ReqRegions.push_back(MR);
-      return;
-    }
+  // Fall back to the summary of the array the request is an element of.
+  if (const ElementRegion *const ER = MR->getAs<ElementRegion>())
+    return State->get<MPIResourceMap>(ER->getSuperRegion());
+  return nullptr;
+}
 
-    const auto &Size = Ctx.getStoreManager().getSizeInElements(
-        Ctx.getState(), SuperRegion,
-        CE.getArgExpr(1)->getType()->getPointeeType());
-    const llvm::APSInt &ArrSize = Size.getAs<nonloc::ConcreteInt>()->getValue();
+const MemRegion *
+MPIChecker::requestArrayUsedByWait(const CallEvent &CE,
+                                   const MemRegion *const MR) const {
+  if (!FuncClassifier->isMPI_Waitall(CE.getCalleeIdentifier()))
+    return nullptr;
+  return requestArrayRegion(MR);
+}
 
-    for (size_t i = 0; i < ArrSize; ++i) {
-      const NonLoc Idx = Ctx.getSValBuilder().makeArrayIndex(i);
+ProgramStateRef MPIChecker::completeRequestArray(
+    const MemRegion *const ArrayRegion, const CallEvent &CE,
+    ProgramStateRef State,
+    llvm::SmallVectorImpl<const MemRegion *> &UnmatchedRegions,
+    CheckerContext &Ctx) const {
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier->getSignature(CE.getCalleeIdentifier());
+  const int LengthIdx = Sig->getArgIndex(MPIFunctionClassifier::Length);
+  const int ReqIdx = Sig->getArgIndex(MPIFunctionClassifier::Requests);
+  if (LengthIdx < 0 || ReqIdx < 0 ||
+      static_cast<unsigned>(ReqIdx) >= CE.getNumArgs())
+    return State;
+
+  // The number of requests is only known if the length is concrete.
+  uint64_t NumRequests = 0;
+  bool IsLengthKnown = false;
+  if (const auto Length =
+          CE.getArgSVal(LengthIdx).getAs<nonloc::ConcreteInt>()) {
+    IsLengthKnown = Length->getValue().isNonNegative();
+    NumRequests = Length->getValue().getLimitedValue();
+  }
+
+  // A pointer into the array, like &reqs[2], passes the requests from its
+  // index on. Requests passed at a symbolic index are not matched exactly.
+  uint64_t Base = 0;
+  bool IsBaseKnown = true;
+  const MemRegion *const MR = argRegion(CE, MPIFunctionClassifier::Requests);
+  if (const ElementRegion *const ER =
+          MR ? MR->getAs<ElementRegion>() : nullptr) {
+    const auto BaseIndex = ER->getIndex().getAs<nonloc::ConcreteInt>();
+    IsBaseKnown = BaseIndex && BaseIndex->getValue().isNonNegative();
+    Base = IsBaseKnown ? BaseIndex->getValue().getLimitedValue() : 0;
+  }
+  const bool IsRangeKnown = IsLengthKnown && IsBaseKnown;
 
-      const ElementRegion *const ER = RegionManager->getElementRegion(
-          CE.getArgExpr(1)->getType()->getPointeeType(), Idx, SuperRegion,
-          Ctx.getASTContext());
+  const MPIResource Waited(MPIResource::Request, MPIResource::Wait,
+                           CE.getOriginExpr());
 
-      ReqRegions.push_back(ER->getAs<MemRegion>());
+  // Complete all requests tracked for elements of the array. This is
+  // proportional to the number of tracked requests, independent of the
+  // length of the array.
+  llvm::SmallSet<uint64_t, 8> Matched;
+  bool IsAnyTracked = false;
+  bool IsAnyIndexSymbolic = false;
+  const auto Resources = State->get<MPIResourceMap>();
+  for (const auto &Req : Resources) {
+    if (Req.second.ResourceKind != MPIResource::Request &&
+        Req.second.ResourceKind != MPIResource::PersistentRequest)
+      continue;
+    uint64_t Index = 0;
+    if (Req.first != ArrayRegion) {
+      const ElementRegion *const ER = dyn_cast<ElementRegion>(Req.first);
+      if (!ER || ER->getSuperRegion() != ArrayRegion)
+        continue;
+      const auto ConcreteIndex = ER->getIndex().getAs<nonloc::ConcreteInt>();
+      if (!ConcreteIndex) {
+        IsAnyIndexSymbolic = true;
+      } else if (ConcreteIndex->getValue().isNegative()) {
+        continue;
+      } else {
+        Index = ConcreteIndex->getValue().getLimitedValue();
+      }
+    }
+    if (IsRangeKnown && !IsAnyIndexSymbolic) {
+      if (Index < Base || Index - Base >= NumRequests)
+        continue;
+      Matched.insert(Index);
     }
-  } else if (FuncClassifier->isMPI_Wait(CE.getCalleeIdentifier())) {
-    ReqRegions.push_back(MR);
+    IsAnyTracked = true;
+    State = completeRequest(State, Req.first, Req.second, CE.getOriginExpr());
+  }
+
+  // Requests of an array that was completed before count as matched. The
+  // array is reported once if any of its elements is not matched, without
+  // creating a region for each element.
+  const MPIResource *const Summary = Resources.lookup(ArrayRegion);
+  if (!Summary || Summary->CurrentState != MPIResource::Wait) {
+    const bool IsAnyUnmatched = IsRangeKnown && !IsAnyIndexSymbolic
+                                    ? Matched.size() != NumRequests
+                                    : !IsAnyTracked;
+    if (IsAnyUnmatched)
+      UnmatchedRegions.push_back(ArrayRegion);
   }
+
+  // Summarize the whole array as completed, instead of binding each element.
+  // Requests passed from a later index leave the leading elements untouched.
+  if ((Summary && Summary->CurrentState == MPIResource::Wait) || Base != 0 ||
+      !IsBaseKnown)
+    return State;
+  return setResource(State, ArrayRegion, Waited);
 }
 
 } // end of namespace: mpi
 } // end of namespace: ento
 } // end of namespace: clang
 
-// Registers the checker for static analysis.
-void clang::ento::registerMPIChecker(CheckerManager &MGR) {
-  MGR.registerChecker<clang::ento::mpi::MPIChecker>();
-}
+// Registers the checkers for static analysis.
+#define REGISTER_CHECKER(name)                                                 \
+  void clang::ento::register##name(CheckerManager &MGR) {                      \
+    mpi::MPIChecker *const Checker = MGR.registerChecker<mpi::MPIChecker>();   \
+    Checker->ChecksEnabled[mpi::MPIChecker::CK_##name] = true;                 \
+    Checker->CheckNames[mpi::MPIChecker::CK_##name] =                          \
+        MGR.getCurrentCheckName();                                             \
+  }
+
+REGISTER_CHECKER(MPIChecker)
+REGISTER_CHECKER(MPIPerformanceChecker)
@@ -20,7 +20,6 @@
 
 #include "MPIBugReporter.h"
 #include "MPITypes.h"
-#include "MPITypes_2.h"
 #include "clang/StaticAnalyzer/Checkers/MPIFunctionClassifier.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/CallEvent.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/CheckerContext.h"
@@ -29,24 +28,89 @@ namespace clang {
 namespace ento {
 namespace mpi {
 
-class MPIChecker : public Checker<check::PreCall, check::DeadSymbols> {
+class MPIChecker
+    : public Checker<check::PreCall, check::PostCall, check::Location,
+                     check::Bind, check::DeadSymbols, check::LiveSymbols,
+                     check::EndFunction, check::EndAnalysis, eval::Call> {
 public:
   MPIChecker() : BReporter(*this) {}
 
+  /// The checks sharing the path-sensitive state of this checker. Errors are
+  /// reported by MPI-Checker, performance issues by the optional
+  /// MPI-Performance checker.
+  enum CheckKind {
+    CK_MPIChecker,
+    CK_MPIPerformanceChecker,
+    CK_NumCheckKinds
+  };
+
+  DefaultBool ChecksEnabled[CK_NumCheckKinds];
+  CheckName CheckNames[CK_NumCheckKinds];
+
   // path-sensitive callbacks
+  /// Runs the checks of a call in sequence. Each check continues from the
+  /// node the previous one returned, so that the state updates and reports
+  /// of all checks end up on a single path. A check returns nullptr if the
+  /// path was cached out, which skips the remaining checks.
   void checkPreCall(const CallEvent &CE, CheckerContext &Ctx) const {
     dynamicInit(Ctx);
-    checkUnmatchedWaits(CE, Ctx);
-    checkDoubleNonblocking(CE, Ctx);
-    checkDoubleClose(CE, Ctx);
+    ExplodedNode *Node = Ctx.getPredecessor();
+    for (const auto Check :
+         {&MPIChecker::checkUnmatchedWaits, &MPIChecker::checkDoubleNonblocking,
+          &MPIChecker::checkDoubleOpen, &MPIChecker::checkDoubleClose,
+          &MPIChecker::checkFileAccess, &MPIChecker::checkFileView,
+          &MPIChecker::checkPersistentRequests, &MPIChecker::checkSpinningTest,
+          &MPIChecker::checkRedundantBarrier, &MPIChecker::checkHeadToHeadSend,
+          &MPIChecker::checkOverlappingCall}) {
+      Node = (this->*Check)(CE, Node, Ctx);
+      if (!Node)
+        return;
+    }
+  }
+
+  void checkPostCall(const CallEvent &CE, CheckerContext &Ctx) const {
+    checkPendingCollectives(CE, Ctx);
+  }
+
+  /// Loads and stores of buffers of pending blocking collectives use their
+  /// results.
+  void checkLocation(SVal Loc, bool IsLoad, const Stmt *S,
+                     CheckerContext &Ctx) const;
+
+  /// Every store is considered work pending communication can overlap with.
+  void checkBind(SVal Loc, SVal Val, const Stmt *S,
+                 CheckerContext &Ctx) const {
+    markOverlappingWork(Ctx.getPredecessor(), Ctx);
   }
 
   void checkDeadSymbols(SymbolReaper &SymReaper, CheckerContext &Ctx) const {
-    dynamicInit(Ctx);
-    checkMissingWaits(SymReaper, Ctx);
-    checkMissingClose(SymReaper, Ctx);
+    checkDeadResources(SymReaper, Ctx);
   }
 
+  /// Keeps the symbolic size and rank of communicators alive, so that their
+  /// constraints are not dropped while the communicator can still be queried.
+  /// Communicators whose handle died are removed by checkDeadResources.
+  /// Handles of derived datatypes and closed files are kept alive while their
+  /// frame is active, as views and later uses refer to them.
+  void checkLiveSymbols(ProgramStateRef State, SymbolReaper &SymReaper) const;
+
+  /// Reports files that are still open when main returns.
+  void checkEndFunction(CheckerContext &Ctx) const;
+
+  /// Reports pairs of processes, that both send to each other before
+  /// receiving, as recorded on the paths of the analyzed function.
+  void checkEndAnalysis(ExplodedGraph &G, BugReporter &BR,
+                        ExprEngine &Eng) const;
+
+  /// Evaluates calls to MPI functions according to their signature. Only
+  /// the arguments the MPI standard allows to be written are invalidated and
+  /// the return value is bound to a fresh symbol, which covers MPI_SUCCESS as
+  /// well as the error codes. Test functions split the state into one where
+  /// the requests completed and one where they are still pending.
+  ///
+  /// \returns true if the call was evaluated
+  bool evalCall(const CallExpr *CE, CheckerContext &Ctx) const;
+
   void dynamicInit(CheckerContext &Ctx) const {
     if (FuncClassifier)
       return;
@@ -59,49 +123,277 @@ public:
   /// in order to only inspect nonblocking functions.
   ///
   /// \param PreCallEvent MPI call to verify
-  void checkDoubleNonblocking(const clang::ento::CallEvent &PreCallEvent,
-                              clang::ento::CheckerContext &Ctx) const;
+  /// \param Pred node the previous checks of the call ended in
+  clang::ento::ExplodedNode *
+  checkDoubleNonblocking(const clang::ento::CallEvent &PreCallEvent,
+                         clang::ento::ExplodedNode *Pred,
+                         clang::ento::CheckerContext &Ctx) const;
 
   /// Checks if the request used by the wait function was not used at all
   /// before. The check contains a guard, in order to only inspect wait
   /// functions.
   ///
   /// \param PreCallEvent MPI call to verify
-  void checkUnmatchedWaits(const clang::ento::CallEvent &PreCallEvent,
-                           clang::ento::CheckerContext &Ctx) const;
+  /// \param Pred node the previous checks of the call ended in
+  clang::ento::ExplodedNode *
+  checkUnmatchedWaits(const clang::ento::CallEvent &PreCallEvent,
+                      clang::ento::ExplodedNode *Pred,
+                      clang::ento::CheckerContext &Ctx) const;
 
   /// Check if a nonblocking call is not matched by a wait.
   /// If a memory region is not alive and the last function using the
   /// request was a nonblocking call, this is rated as a missing wait.
-  void checkMissingWaits(clang::ento::SymbolReaper &SymReaper,
-                         clang::ento::CheckerContext &Ctx) const;
+  /// Likewise, a file that is still open when its handle dies is rated as a
+  /// missing close and a persistent request that was not freed as a leak.
+  /// All dead resources are removed in a single sweep, which adds at most one
+  /// transition and none if no resource died.
+  void checkDeadResources(clang::ento::SymbolReaper &SymReaper,
+                          clang::ento::CheckerContext &Ctx) const;
 
-  // Check if the file handle is closed twice
-  // \param PreCallEvent MPI call to verifiy (MPI_File_close(fh))
-  void checkDoubleClose(const clang::ento::CallEvent &PreCallEvent,
+  /// Checks if a file handle is closed twice without intermediate open.
+  /// The check contains a guard, in order to only inspect MPI_File_close.
+  ///
+  /// \param PreCallEvent MPI call to verify
+  /// \param Pred node the previous checks of the call ended in
+  clang::ento::ExplodedNode *
+  checkDoubleClose(const clang::ento::CallEvent &PreCallEvent,
+                   clang::ento::ExplodedNode *Pred,
+                   clang::ento::CheckerContext &Ctx) const;
+
+  /// Checks if a file handle is opened twice without intermediate close.
+  /// The check contains a guard, in order to only inspect MPI_File_open.
+  ///
+  /// \param PreCallEvent MPI call to verify
+  /// \param Pred node the previous checks of the call ended in
+  clang::ento::ExplodedNode *
+  checkDoubleOpen(const clang::ento::CallEvent &PreCallEvent,
+                  clang::ento::ExplodedNode *Pred,
+                  clang::ento::CheckerContext &Ctx) const;
+
+  /// Checks if a file handle used by a data access, MPI_File_set_view or
+  /// any other call taking an open file was closed before or never opened.
+  ///
+  /// \param PreCallEvent MPI call to verify
+  /// \param Pred node the previous checks of the call ended in
+  clang::ento::ExplodedNode *
+  checkFileAccess(const clang::ento::CallEvent &PreCallEvent,
+                  clang::ento::ExplodedNode *Pred,
+                  clang::ento::CheckerContext &Ctx) const;
+
+  /// Tracks the life cycle of persistent requests. Requests created by the
+  /// *_init functions are inactive until they are started by MPI_Start or
+  /// MPI_Startall, and inactive again once completed. Starting an active
+  /// request is rated as a double start. MPI_Request_free releases a request.
+  ///
+  /// \param PreCallEvent MPI call to verify
+  /// \param Pred node the previous checks of the call ended in
+  clang::ento::ExplodedNode *
+  checkPersistentRequests(const clang::ento::CallEvent &PreCallEvent,
+                          clang::ento::ExplodedNode *Pred,
+                          clang::ento::CheckerContext &Ctx) const;
+
+  /// Checks if requests are tested again, after a previous test did not
+  /// complete them and no work was done in between. The check contains a
+  /// guard, in order to only inspect test functions.
+  ///
+  /// \param PreCallEvent MPI call to verify
+  /// \param Pred node the previous checks of the call ended in
+  clang::ento::ExplodedNode *
+  checkSpinningTest(const clang::ento::CallEvent &PreCallEvent,
+                    clang::ento::ExplodedNode *Pred,
+                    clang::ento::CheckerContext &Ctx) const;
+
+  /// Checks if a barrier is called right before or after a collective that
+  /// synchronizes the same communicator, without work in between. The check
+  /// contains a guard, in order to only inspect synchronizing collectives.
+  ///
+  /// \param PreCallEvent MPI call to verify
+  /// \param Pred node the previous checks of the call ended in
+  clang::ento::ExplodedNode *
+  checkRedundantBarrier(const clang::ento::CallEvent &PreCallEvent,
+                        clang::ento::ExplodedNode *Pred,
                         clang::ento::CheckerContext &Ctx) const;
 
-  // Should check if there is no following file close after open
-  void checkMissingClose(clang::ento::SymbolReaper &SymReaper,
-                     clang::ento::CheckerContext &Ctx) const;
+  /// Tracks blocking collectives that have a nonblocking variant, until
+  /// their buffers are used. Calls taking such a buffer use it, which
+  /// reports the collective if work was done in between.
+  ///
+  /// \param PostCallEvent evaluated call
+  void checkPendingCollectives(const clang::ento::CallEvent &PostCallEvent,
+                               clang::ento::CheckerContext &Ctx) const;
+
+  /// Ends the pending collective one of whose buffers is used. If work was
+  /// done since the collective was called, it is reported as a candidate for
+  /// its nonblocking variant.
+  ///
+  /// \param Base base region of the used memory
+  /// \param IsLoad true if the memory is only read
+  /// \param UncountedWork work counted since, which is part of the use
+  /// \param ErrorNode node reports are attached to, created on first report
+  ///
+  /// \returns state without the buffers of the used collective
+  ProgramStateRef endPendingCollective(ProgramStateRef State,
+                                       const MemRegion *const Base,
+                                       const bool IsLoad,
+                                       const unsigned UncountedWork,
+                                       ExplodedNode *&ErrorNode,
+                                       CheckerContext &Ctx) const;
+
+  /// Checks if a blocking receive is called for a peer a blocking send was
+  /// called for before. The rank of the path and the peer are recorded, to
+  /// match them with the paths of the peer at the end of the analysis. The
+  /// check contains a guard, in order to only inspect blocking receives.
+  ///
+  /// \param PreCallEvent MPI call to verify
+  /// \param Pred node the previous checks of the call ended in
+  clang::ento::ExplodedNode *
+  checkHeadToHeadSend(const clang::ento::CallEvent &PreCallEvent,
+                      clang::ento::ExplodedNode *Pred,
+                      clang::ento::CheckerContext &Ctx) const;
+
+  /// Records the known peers blocking sends are called for and receives are
+  /// posted for.
+  ///
+  /// \param CE evaluated MPI call
+  /// \param Sig signature of the called function
+  /// \param State state the call is evaluated in
+  ///
+  /// \returns state with the pending sends and received peers updated
+  ProgramStateRef trackPointToPointOrder(
+      const CallExpr *CE, const MPIFunctionClassifier::Signature &Sig,
+      ProgramStateRef State, CheckerContext &Ctx) const;
 
-  // just for testing the open detection
-  void checkDoubleOpen(const clang::ento::CallEvent &PreCallEvent,
-                     clang::ento::CheckerContext &Ctx) const;
+  /// Checks if a data access uses a datatype that is not built from the
+  /// etype of the view set on the file, and if the access is independent
+  /// while the filetype of the view is noncontiguous. The check contains a
+  /// guard, in order to only inspect data access functions.
+  ///
+  /// \param PreCallEvent MPI call to verify
+  /// \param Pred node the previous checks of the call ended in
+  clang::ento::ExplodedNode *
+  checkFileView(const clang::ento::CallEvent &PreCallEvent,
+                clang::ento::ExplodedNode *Pred,
+                clang::ento::CheckerContext &Ctx) const;
+
+  /// Records datatypes created by type constructors as resources of their
+  /// handle, and the call to MPI_File_set_view as origin of the open file it
+  /// sets the view of. Opening or closing a file drops its view.
+  ///
+  /// \param CE evaluated MPI call
+  /// \param Sig signature of the called function
+  /// \param State state the call is evaluated in
+  ///
+  /// \returns state with the datatypes and file views updated
+  ProgramStateRef trackFileViews(
+      const CallExpr *CE, const MPIFunctionClassifier::Signature &Sig,
+      ProgramStateRef State, CheckerContext &Ctx) const;
+
+  /// Checks if a call does work pending nonblocking communication can
+  /// overlap with. The check contains a guard, in order to only inspect
+  /// functions that are not part of MPI.
+  ///
+  /// \param PreCallEvent call to inspect
+  /// \param Pred node the previous checks of the call ended in
+  clang::ento::ExplodedNode *
+  checkOverlappingCall(const clang::ento::CallEvent &PreCallEvent,
+                       clang::ento::ExplodedNode *Pred,
+                       clang::ento::CheckerContext &Ctx) const;
 private:
-  /// Collects all memory regions of a request(array) used by a wait
-  /// function. If the wait function uses a single request, this is a single
-  /// region. For wait functions using multiple requests, multiple regions
-  /// representing elements in the array are collected.
-  ///
-  /// \param ReqRegions vector the regions get pushed into
-  /// \param MR top most region to iterate
-  /// \param CE MPI wait call using the request(s)
-  void allRegionsUsedByWait(
-      llvm::SmallVector<const clang::ento::MemRegion *, 2> &ReqRegions,
-      const clang::ento::MemRegion *const MR, const clang::ento::CallEvent &CE,
+  /// Layout of a datatype. The element type is the key of the predefined
+  /// datatype it is built from, or null if it is unknown.
+  struct DatatypeLayout {
+    const void *Element;
+    bool IsContiguous;
+  };
+
+  /// Resolves the layout of the datatype a handle refers to. Derived
+  /// datatypes are followed through the constructors that created them.
+  /// Unknown datatypes are assumed to be contiguous.
+  ///
+  /// \param Handle expression evaluating to the datatype handle
+  /// \param Value value of the handle, unknown if it is read from the state
+  /// \param State state the handle is resolved in
+  /// \param Depth number of constructors followed so far
+  ///
+  /// \returns layout of the datatype
+  DatatypeLayout datatypeLayout(const Expr *Handle, SVal Value,
+                                ProgramStateRef State, CheckerContext &Ctx,
+                                unsigned Depth = 0) const;
+
+  /// Marks all requests waiting for overlapping work as overlapped, all
+  /// polled requests as polled with work in between and ends the adjacency
+  /// of collectives. The work is counted for pending blocking collectives.
+  ///
+  /// \param Pred node the work is done at
+  /// \returns node with the work marked
+  clang::ento::ExplodedNode *
+  markOverlappingWork(clang::ento::ExplodedNode *Pred,
+                      clang::ento::CheckerContext &Ctx) const;
+
+  /// Records the communicator synchronized by a blocking collective. Any
+  /// other MPI call ends the adjacency of previous collectives.
+  ///
+  /// \param CE evaluated MPI call
+  /// \param Sig signature of the called function
+  /// \param State state the call is evaluated in
+  ///
+  /// \returns state with the synchronized communicators updated
+  ProgramStateRef trackSynchronization(
+      const CallExpr *CE, const MPIFunctionClassifier::Signature &Sig,
+      ProgramStateRef State, CheckerContext &Ctx) const;
+
+  /// Returns true if the function is a blocking collective that every
+  /// process of the communicator has to enter before any process leaves it.
+  bool isSynchronizing(const IdentifierInfo *const IdentInfo) const;
+
+  /// Completes the requests used by MPI_Test*, MPI_Waitany and MPI_Waitsome.
+  /// Which requests of an array complete is unknown, so all of them are
+  /// completed. This loses precision for MPI_Testany and MPI_Waitany, which
+  /// complete a single request. If the function has a flag, or a count of
+  /// completed requests like MPI_Testsome, the requests are only completed in
+  /// the state where it is not zero.
+  ///
+  /// \param CE MPI completion call
+  /// \param Sig signature of the called function
+  /// \param State state after the call was evaluated
+  void evalCompletion(const CallExpr *CE,
+                      const MPIFunctionClassifier::Signature &Sig,
+                      ProgramStateRef State, CheckerContext &Ctx) const;
+
+  /// Returns the request array used by MPI_Waitall, or nullptr if the wait
+  /// function uses a single request.
+  ///
+  /// \param CE MPI wait call
+  /// \param MR top most region used by the wait call
+  const clang::ento::MemRegion *
+  requestArrayUsedByWait(const clang::ento::CallEvent &CE,
+                         const clang::ento::MemRegion *const MR) const;
+
+  /// Completes all requests of an array used by MPI_Waitall. Instead of
+  /// binding every element, the tracked requests of the array are completed
+  /// and the array region itself is marked as a summary of its elements.
+  /// This also covers arrays of symbolic length and heap allocated arrays.
+  /// The requests start at the element the argument points to. The array is
+  /// unmatched if some of a concrete number of requests are not tracked,
+  /// otherwise if no element is tracked.
+  ///
+  /// \param ArrayRegion region of the request array
+  /// \param CE MPI wait call using the requests
+  /// \param State state to update
+  /// \param UnmatchedRegions receives the array if it is unmatched
+  /// \returns state with the completed requests
+  clang::ento::ProgramStateRef completeRequestArray(
+      const clang::ento::MemRegion *const ArrayRegion,
+      const clang::ento::CallEvent &CE, clang::ento::ProgramStateRef State,
+      llvm::SmallVectorImpl<const clang::ento::MemRegion *> &UnmatchedRegions,
       clang::ento::CheckerContext &Ctx) const;
 
+  /// Returns the tracked request of a region. Elements of a request array
+  /// without own entry fall back to the summary of the array.
+  const MPIResource *
+  requestState(clang::ento::ProgramStateRef State,
+               const clang::ento::MemRegion *const MR) const;
+
   /// Returns the memory region used by a wait function.
   /// Distinguishes between MPI_Wait and MPI_Waitall.
   ///
@@ -109,9 +401,45 @@ private:
   const clang::ento::MemRegion *
   topRegionUsedByWait(const clang::ento::CallEvent &CE) const;
 
+  /// Binds the output of MPI_Comm_size and MPI_Comm_rank to the symbolic size
+  /// and rank of the communicator passed. The size is constrained to be
+  /// positive and the rank to lie in [0, size), so that rank dependent
+  /// branches can be pruned.
+  ///
+  /// \param CE MPI call
+  /// \param Sig signature of the called function
+  /// \param State state the output is bound in
+  ProgramStateRef
+  bindRankAndSize(const CallExpr *CE,
+                  const MPIFunctionClassifier::Signature &Sig,
+                  ProgramStateRef State, CheckerContext &Ctx) const;
+
+  /// Returns the memory region of the first argument with the given role,
+  /// as described by the signature of the called MPI function.
+  ///
+  /// \param CE MPI call
+  /// \param Role role of the argument
+  const clang::ento::MemRegion *
+  argRegion(const clang::ento::CallEvent &CE,
+            MPIFunctionClassifier::ArgRole Role) const;
+
   const std::unique_ptr<MPIFunctionClassifier> FuncClassifier;
   MPIBugReporter BReporter;
 
+  /// A path that calls a blocking receive from a known peer after a blocking
+  /// send to it. The state is the one the receive is called in.
+  struct SendBeforeReceive {
+    ProgramStateRef State;
+    const LocationContext *LCtx;
+    SymbolRef Rank;
+    const llvm::APSInt *Peer;
+    const CallExpr *Send;
+    const CallExpr *Recv;
+  };
+
+  /// Paths of the function currently analyzed that send before receiving.
+  mutable std::vector<SendBeforeReceive> SendsBeforeReceives;
+
 };
 
 } // end of namespace: mpi
@@ -8,9 +8,9 @@
 //===----------------------------------------------------------------------===//
 ///
 /// \file
-/// This file provides definitions to model concepts of MPI. The mpi::Request
-/// class defines a wrapper class, in order to make MPI requests trackable for
-/// path-sensitive analysis.
+/// This file provides definitions to model concepts of MPI. The
+/// mpi::MPIResource class defines a wrapper class, in order to make MPI
+/// requests and handles trackable for path-sensitive analysis.
 ///
 //===----------------------------------------------------------------------===//
 
@@ -25,38 +25,240 @@ namespace clang {
 namespace ento {
 namespace mpi {
 
-class Request {
+// An MPI resource tracked by the checker, like a request or a file handle.
+// The kind and the state of the resource are packed into a single byte each.
+// The origin is the MPI call that put the resource into its current state.
+// Derived datatypes originate from their type constructor, open files from
+// the call that opened them or the last call to MPI_File_set_view.
+class MPIResource {
 public:
-  enum State : unsigned char { Nonblocking, Wait };
+  enum Kind : unsigned char { Request, PersistentRequest, File, Datatype };
 
-  Request(State S) : CurrentState{S} {}
+  // Requests are either nonblocking or waited for, persistent requests are
+  // inactive or active. Files are open until they are closed, derived
+  // datatypes are always open.
+  enum State : unsigned char {
+    Nonblocking,
+    Wait,
+    Inactive,
+    Active,
+    Open,
+    Close
+  };
+
+  MPIResource(Kind K, State S, const Expr *Origin = nullptr)
+      : ResourceKind{K}, CurrentState{S}, Origin{Origin} {}
 
   void Profile(llvm::FoldingSetNodeID &Id) const {
-    Id.AddInteger(CurrentState);
+    Id.AddInteger(static_cast<unsigned>(ResourceKind) << 8 | CurrentState);
+    Id.AddPointer(Origin);
   }
 
-  bool operator==(const Request &ToCompare) const {
-    return CurrentState == ToCompare.CurrentState;
+  bool operator==(const MPIResource &ToCompare) const {
+    return ResourceKind == ToCompare.ResourceKind &&
+           CurrentState == ToCompare.CurrentState &&
+           Origin == ToCompare.Origin;
   }
 
+  const Kind ResourceKind;
   const State CurrentState;
+  const Expr *const Origin;
+};
+
+// The MPIResourceMap stores all MPI resources, which are identified by the
+// memory region of their handle. Requests are used in MPI to complete
+// nonblocking operations with wait operations, file handles have to be closed
+// after they were opened. A single map is used for all kinds of resources, so
+// that the state only carries one trait for MPI. A custom map implementation
+// is used, in order to make it available in an arbitrary amount of
+// translation units.
+struct MPIResourceMap {};
+typedef llvm::ImmutableMap<const clang::ento::MemRegion *,
+                           clang::ento::mpi::MPIResource>
+    MPIResourceMapImpl;
+
+// Index of the base regions of all tracked resources, which maps each base
+// region to the number of resources stored in it. As a region is live if its
+// base region is, dead resources are found by checking the base regions.
+struct MPIResourceBaseMap {};
+typedef llvm::ImmutableMap<const clang::ento::MemRegion *, unsigned>
+    MPIResourceBaseMapImpl;
+
+// Symbolic size and rank of a communicator, as returned by MPI_Comm_size and
+// MPI_Comm_rank. The rank is null until MPI_Comm_rank is called. The handle
+// is the value the communicator was queried with, which decides when the
+// communicator dies.
+class Communicator {
+public:
+  Communicator(SVal Handle, SymbolRef Size, SymbolRef Rank)
+      : Handle{Handle}, Size{Size}, Rank{Rank} {}
+
+  void Profile(llvm::FoldingSetNodeID &Id) const {
+    Handle.Profile(Id);
+    Id.AddPointer(Size);
+    Id.AddPointer(Rank);
+  }
+
+  bool operator==(const Communicator &ToCompare) const {
+    return Handle == ToCompare.Handle && Size == ToCompare.Size &&
+           Rank == ToCompare.Rank;
+  }
+
+  const SVal Handle;
+  const SymbolRef Size;
+  const SymbolRef Rank;
+};
+
+// Communicators are identified by the region, symbol or uniqued integer
+// constant their handle evaluates to. Communicators are removed once their
+// handle is dead, integer constants never die.
+struct CommunicatorMap {};
+typedef llvm::ImmutableMap<const void *, clang::ento::mpi::Communicator>
+    CommunicatorMapImpl;
+
+// Requests whose nonblocking call has not been followed by any non-MPI work
+// yet. Waiting for such a request leaves no room to overlap the
+// communication with computation. Only tracked by the performance checks.
+struct NoOverlapRequestSet {};
+typedef llvm::ImmutableSet<const clang::ento::MemRegion *>
+    NoOverlapRequestSetImpl;
+
+// Requests or arrays of requests that were tested without completing and have
+// not been followed by any non-MPI work since. Testing them again spins.
+// Only tracked by the performance checks.
+struct PolledRequestSet {};
+typedef llvm::ImmutableSet<const clang::ento::MemRegion *>
+    PolledRequestSetImpl;
+
+// A blocking collective whose buffer has not been used since the call. Work
+// counts the stores and calls to non-MPI functions made since, which could
+// overlap the nonblocking variant of the collective. Send buffers may still
+// be read while the collective is pending.
+class PendingCollective {
+public:
+  PendingCollective(const CallExpr *Call, unsigned Work, bool IsSendBuffer)
+      : Call{Call}, Work{Work}, IsSendBuffer{IsSendBuffer} {}
+
+  void Profile(llvm::FoldingSetNodeID &Id) const {
+    Id.AddPointer(Call);
+    Id.AddInteger(Work);
+    Id.AddBoolean(IsSendBuffer);
+  }
+
+  bool operator==(const PendingCollective &ToCompare) const {
+    return Call == ToCompare.Call && Work == ToCompare.Work &&
+           IsSendBuffer == ToCompare.IsSendBuffer;
+  }
+
+  const CallExpr *const Call;
+  const unsigned Work;
+  const bool IsSendBuffer;
 };
 
-// The RequestMap stores MPI requests which are identified by their memory
-// region. Requests are used in MPI to complete nonblocking operations with wait
-// operations. A custom map implementation is used, in order to make it
-// available in an arbitrary amount of translation units.
-struct RequestMap {};
+// Pending blocking collectives, identified by the base regions of their
+// buffers. Only tracked by the performance checks.
+struct PendingCollectiveMap {};
 typedef llvm::ImmutableMap<const clang::ento::MemRegion *,
-                           clang::ento::mpi::Request>
-    RequestMapImpl;
+                           clang::ento::mpi::PendingCollective>
+    PendingCollectiveMapImpl;
+
+// Peers, identified by their known rank, a blocking send was called for on
+// the path before any receive from them was posted, mapped to the send. Only
+// tracked by the performance checks.
+struct PendingSendMap {};
+typedef llvm::ImmutableMap<const void *, const clang::CallExpr *>
+    PendingSendMapImpl;
+
+// Peers, identified by their known rank, a receive was posted for on the
+// path. Sends to them are no longer considered for head-to-head exchanges.
+struct ReceivedPeerSet {};
+typedef llvm::ImmutableSet<const void *> ReceivedPeerSetImpl;
+
+// Communicators synchronized by a blocking collective, mapped to its call,
+// that have not been followed by any work or other MPI call since. Only
+// tracked by the performance checks.
+struct SynchronizedCommMap {};
+typedef llvm::ImmutableMap<const void *, const clang::CallExpr *>
+    SynchronizedCommMapImpl;
 
 } // end of namespace: mpi
 
 
 template <>
-struct ProgramStateTrait<mpi::RequestMap>
-    : public ProgramStatePartialTrait<mpi::RequestMapImpl> {
+struct ProgramStateTrait<mpi::MPIResourceMap>
+    : public ProgramStatePartialTrait<mpi::MPIResourceMapImpl> {
+  static void *GDMIndex() {
+    static int index = 0;
+    return &index;
+  }
+};
+
+template <>
+struct ProgramStateTrait<mpi::MPIResourceBaseMap>
+    : public ProgramStatePartialTrait<mpi::MPIResourceBaseMapImpl> {
+  static void *GDMIndex() {
+    static int index = 0;
+    return &index;
+  }
+};
+
+template <>
+struct ProgramStateTrait<mpi::CommunicatorMap>
+    : public ProgramStatePartialTrait<mpi::CommunicatorMapImpl> {
+  static void *GDMIndex() {
+    static int index = 0;
+    return &index;
+  }
+};
+
+template <>
+struct ProgramStateTrait<mpi::NoOverlapRequestSet>
+    : public ProgramStatePartialTrait<mpi::NoOverlapRequestSetImpl> {
+  static void *GDMIndex() {
+    static int index = 0;
+    return &index;
+  }
+};
+
+template <>
+struct ProgramStateTrait<mpi::PolledRequestSet>
+    : public ProgramStatePartialTrait<mpi::PolledRequestSetImpl> {
+  static void *GDMIndex() {
+    static int index = 0;
+    return &index;
+  }
+};
+
+template <>
+struct ProgramStateTrait<mpi::SynchronizedCommMap>
+    : public ProgramStatePartialTrait<mpi::SynchronizedCommMapImpl> {
+  static void *GDMIndex() {
+    static int index = 0;
+    return &index;
+  }
+};
+
+template <>
+struct ProgramStateTrait<mpi::PendingCollectiveMap>
+    : public ProgramStatePartialTrait<mpi::PendingCollectiveMapImpl> {
+  static void *GDMIndex() {
+    static int index = 0;
+    return &index;
+  }
+};
+
+template <>
+struct ProgramStateTrait<mpi::PendingSendMap>
+    : public ProgramStatePartialTrait<mpi::PendingSendMapImpl> {
+  static void *GDMIndex() {
+    static int index = 0;
+    return &index;
+  }
+};
+
+template <>
+struct ProgramStateTrait<mpi::ReceivedPeerSet>
+    : public ProgramStatePartialTrait<mpi::ReceivedPeerSetImpl> {
   static void *GDMIndex() {
     static int index = 0;
     return &index;
@@ -11,6 +11,7 @@ typedef int MPI_Status;
 typedef int MPI_Op;
 typedef int MPI_File;
 typedef int MPI_Offset;
+typedef int MPI_Info;
 typedef int int8_t;
 typedef int uint8_t;
 typedef int uint16_t;
@@ -19,28 +20,30 @@ namespace std { template<class T> struct complex { T real; T imag; }; }
 
 // mock constants
 #define MPI_DATATYPE_NULL 0
-#define MPI_CHAR 0
-#define MPI_BYTE 0
-#define MPI_INT 0
-#define MPI_LONG 0
-#define MPI_LONG_DOUBLE 0
-#define MPI_UNSIGNED 0
-#define MPI_INT8_T 0
-#define MPI_UINT8_T 0
-#define MPI_UINT16_T 0
-#define MPI_C_LONG_DOUBLE_COMPLEX 0
-#define MPI_FLOAT 0
-#define MPI_DOUBLE 0
-#define MPI_CXX_BOOL 0
-#define MPI_CXX_FLOAT_COMPLEX 0
-#define MPI_CXX_DOUBLE_COMPLEX 0
-#define MPI_CXX_LONG_DOUBLE_COMPLEX 0
+#define MPI_CHAR 1
+#define MPI_BYTE 2
+#define MPI_INT 3
+#define MPI_LONG 4
+#define MPI_LONG_DOUBLE 5
+#define MPI_UNSIGNED 6
+#define MPI_INT8_T 7
+#define MPI_UINT8_T 8
+#define MPI_UINT16_T 9
+#define MPI_C_LONG_DOUBLE_COMPLEX 10
+#define MPI_FLOAT 11
+#define MPI_DOUBLE 12
+#define MPI_CXX_BOOL 13
+#define MPI_CXX_FLOAT_COMPLEX 14
+#define MPI_CXX_DOUBLE_COMPLEX 15
+#define MPI_CXX_LONG_DOUBLE_COMPLEX 16
 #define MPI_IN_PLACE 0
 #define MPI_COMM_WORLD 0
 #define MPI_STATUS_IGNORE 0
 #define MPI_STATUSES_IGNORE 0
 #define MPI_SUM 0
 #define MPI_INFO_NULL 0 // no extras being passed into a routine
+#define MPI_MODE_RDWR 0
+#define MPI_ORDER_C 0
 
 // mock functions
 int MPI_Comm_size(MPI_Comm, int *);
@@ -50,12 +53,42 @@ int MPI_Recv(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Status *);
 int MPI_Isend(const void *, int, MPI_Datatype, int, int, MPI_Comm,
     MPI_Request *);
 int MPI_Irecv(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
+int MPI_Bsend(const void *, int, MPI_Datatype, int, int, MPI_Comm);
+int MPI_Sendrecv(const void *, int, MPI_Datatype, int, int, void *, int,
+    MPI_Datatype, int, int, MPI_Comm, MPI_Status *);
 int MPI_Wait(MPI_Request *, MPI_Status *);
 int MPI_Waitall(int, MPI_Request[], MPI_Status[]);
+int MPI_Waitany(int, MPI_Request[], int *, MPI_Status *);
+int MPI_Waitsome(int, MPI_Request[], int *, int[], MPI_Status[]);
+int MPI_Test(MPI_Request *, int *, MPI_Status *);
+int MPI_Testall(int, MPI_Request[], int *, MPI_Status[]);
+int MPI_Testany(int, MPI_Request[], int *, int *, MPI_Status *);
+int MPI_Testsome(int, MPI_Request[], int *, int[], MPI_Status[]);
+int MPI_Send_init(const void *, int, MPI_Datatype, int, int, MPI_Comm,
+    MPI_Request *);
+int MPI_Recv_init(void *, int, MPI_Datatype, int, int, MPI_Comm,
+    MPI_Request *);
+int MPI_Start(MPI_Request *);
+int MPI_Startall(int, MPI_Request[]);
+int MPI_Request_free(MPI_Request *);
+int MPI_Barrier(MPI_Comm);
 int MPI_Reduce(const void *, void *, int, MPI_Datatype, MPI_Op, int, MPI_Comm);
+int MPI_Allreduce(const void *, void *, int, MPI_Datatype, MPI_Op, MPI_Comm);
 int MPI_Ireduce(const void *, void *, int, MPI_Datatype, MPI_Op, int, MPI_Comm,
     MPI_Request *);
 int MPI_Bcast(void *, int count, MPI_Datatype, int, MPI_Comm);
+int MPI_Type_contiguous(int, MPI_Datatype, MPI_Datatype *);
+int MPI_Type_vector(int, int, int, MPI_Datatype, MPI_Datatype *);
+int MPI_Type_create_subarray(int, const int[], const int[], const int[], int,
+    MPI_Datatype, MPI_Datatype *);
+int MPI_Type_commit(MPI_Datatype *);
+int MPI_File_open(MPI_Comm, const char *, int, MPI_Info, MPI_File *);
+int MPI_File_close(MPI_File *);
+int MPI_File_set_view(MPI_File, MPI_Offset, MPI_Datatype, MPI_Datatype,
+    const char *, MPI_Info);
+int MPI_File_read_all(MPI_File, void *, int, MPI_Datatype, MPI_Status *);
+int MPI_File_write_all(MPI_File, const void *, int, MPI_Datatype,
+    MPI_Status *);
 int MPI_File_read(MPI_File, void *, int, MPI_Datatype, MPI_Status *);
 int MPI_File_write(MPI_File, const void *, int, MPI_Datatype, MPI_Status *);
 int MPI_File_read_at(MPI_File, MPI_Offset, void *, int, MPI_Datatype, MPI_Status *);
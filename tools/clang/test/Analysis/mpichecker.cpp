@@ -1,7 +1,9 @@
-// RUN: %clang_analyze_cc1 -analyzer-checker=optin.mpi.MPI-Checker -verify %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=optin.mpi.MPI-Checker,debug.ExprInspection -verify %s
 
 #include "MPIMock.h"
 
+void clang_analyzer_eval(int);
+
 void matchedWait1() {
   int rank = 0;
   double buf = 0;
@@ -172,7 +174,7 @@ void missingNonBlockingWaitall() {
   MPI_Ireduce(MPI_IN_PLACE, &buf, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD,
       &req[3]);
 
-  MPI_Waitall(4, req, MPI_STATUSES_IGNORE); // expected-warning{{Request 'req[2]' has no matching nonblocking call.}}
+  MPI_Waitall(4, req, MPI_STATUSES_IGNORE); // expected-warning{{Request 'req' has no matching nonblocking call.}}
 }
 
 void missingNonBlockingWaitall2() {
@@ -186,7 +188,7 @@ void missingNonBlockingWaitall2() {
   MPI_Ireduce(MPI_IN_PLACE, &buf, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD,
       &req[3]);
 
-  MPI_Waitall(4, req, MPI_STATUSES_IGNORE); // expected-warning-re 2{{Request '{{(.*)[[1-2]](.*)}}' has no matching nonblocking call.}}
+  MPI_Waitall(4, req, MPI_STATUSES_IGNORE); // expected-warning{{Request 'req' has no matching nonblocking call.}}
 }
 
 void missingNonBlockingWaitall3() {
@@ -200,14 +202,14 @@ void missingNonBlockingWaitall3() {
   MPI_Ireduce(MPI_IN_PLACE, &buf, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD,
       &req[2]);
 
-  MPI_Waitall(4, req, MPI_STATUSES_IGNORE); // expected-warning-re 2{{Request '{{(.*)[[1,3]](.*)}}' has no matching nonblocking call.}}
+  MPI_Waitall(4, req, MPI_STATUSES_IGNORE); // expected-warning{{Request 'req' has no matching nonblocking call.}}
 }
 
 void missingNonBlockingWaitall4() {
   int rank = 0;
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
   MPI_Request req[4];
-  MPI_Waitall(4, req, MPI_STATUSES_IGNORE); // expected-warning-re 4{{Request '{{(.*)[[0-3]](.*)}}' has no matching nonblocking call.}}
+  MPI_Waitall(4, req, MPI_STATUSES_IGNORE); // expected-warning{{Request 'req' has no matching nonblocking call.}}
 }
 
 void noDoubleRequestUsage() {
@@ -340,3 +342,245 @@ void externFunctions2() {
   void callNonblockingExtern(MPI_Request *req);
   callNonblockingExtern(&req);
 }
+
+int globalValue;
+
+void evalCallPreservesGlobals() {
+  int buf = 1;
+  globalValue = 1;
+  MPI_Send(&buf, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
+  clang_analyzer_eval(globalValue == 1); // expected-warning{{TRUE}}
+  clang_analyzer_eval(buf == 1); // expected-warning{{TRUE}}
+}
+
+void evalCallInvalidatesOutputs() {
+  int buf = 1;
+  globalValue = 1;
+  MPI_Recv(&buf, 1, MPI_INT, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  clang_analyzer_eval(buf == 1); // expected-warning{{UNKNOWN}}
+  clang_analyzer_eval(globalValue == 1); // expected-warning{{TRUE}}
+}
+
+void evalCallReturnValue() {
+  double buf = 0;
+  int rc = MPI_Send(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+  clang_analyzer_eval(rc == 0); // expected-warning{{UNKNOWN}}
+}
+
+void rankAndSizeConstraints() {
+  int rank, size;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  clang_analyzer_eval(size >= 1); // expected-warning{{TRUE}}
+  clang_analyzer_eval(rank >= 0); // expected-warning{{TRUE}}
+}
+
+void sizeIsStable() {
+  int size1, size2;
+  MPI_Comm_size(MPI_COMM_WORLD, &size1);
+  MPI_Comm_size(MPI_COMM_WORLD, &size2);
+  clang_analyzer_eval(size1 == size2); // expected-warning{{TRUE}}
+}
+
+void rankBelowKnownSize() {
+  int rank, size;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (size != 2)
+    return;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  clang_analyzer_eval(rank < 2); // expected-warning{{TRUE}}
+}
+
+void symbolicLengthWaitall(int n) {
+  double buf = 0;
+  MPI_Request req[8];
+  MPI_Ireduce(MPI_IN_PLACE, &buf, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD,
+              &req[0]);
+  MPI_Ireduce(MPI_IN_PLACE, &buf, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD,
+              &req[1]);
+  MPI_Waitall(n, req, MPI_STATUSES_IGNORE);
+} // no error
+
+void offsetRequestsWaitall() {
+  double buf = 0;
+  MPI_Request req[4];
+  MPI_Isend(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req[2]);
+  MPI_Isend(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req[3]);
+  MPI_Waitall(2, &req[2], MPI_STATUSES_IGNORE);
+} // no error
+
+void offsetRequestsMissingNonblocking() {
+  double buf = 0;
+  MPI_Request req[4];
+  MPI_Isend(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req[0]);
+  MPI_Isend(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req[1]);
+  MPI_Waitall(2, &req[1], MPI_STATUSES_IGNORE); // expected-warning{{Request 'req' has no matching nonblocking call.}}
+  MPI_Wait(&req[0], MPI_STATUS_IGNORE);
+}
+
+void heapRequestsWaitall(int n) {
+  double buf = 0;
+  MPI_Request *req = new MPI_Request[n];
+  MPI_Ireduce(MPI_IN_PLACE, &buf, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD,
+              &req[0]);
+  MPI_Ireduce(MPI_IN_PLACE, &buf, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD,
+              &req[1]);
+  MPI_Waitall(n, req, MPI_STATUSES_IGNORE);
+  MPI_Wait(&req[1], MPI_STATUS_IGNORE);
+  delete[] req;
+} // no error
+
+void heapRequestsMissingNonblocking(int n) {
+  MPI_Request *req = new MPI_Request[n];
+  MPI_Waitall(n, req, MPI_STATUSES_IGNORE); // expected-warning-re{{Request {{.*}}has no matching nonblocking call.}}
+  delete[] req;
+}
+
+void persistentRequest() {
+  double buf = 0;
+  MPI_Request req;
+  MPI_Send_init(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req);
+  for (int i = 0; i < 2; ++i) {
+    MPI_Start(&req);
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+  }
+  MPI_Request_free(&req);
+} // no error
+
+void doubleStart() {
+  double buf = 0;
+  MPI_Request req;
+  MPI_Recv_init(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req);
+  MPI_Start(&req);
+  MPI_Start(&req); // expected-warning{{Double start on persistent request 'req'.}}
+  MPI_Wait(&req, MPI_STATUS_IGNORE);
+  MPI_Request_free(&req);
+}
+
+void persistentStartall() {
+  double buf = 0;
+  MPI_Request req[2];
+  MPI_Send_init(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req[0]);
+  MPI_Recv_init(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req[1]);
+  MPI_Startall(2, req);
+  MPI_Waitall(2, req, MPI_STATUSES_IGNORE);
+  MPI_Startall(2, req);
+  MPI_Startall(2, req); // expected-warning{{Double start on persistent request 'req[0]'.}} expected-warning{{Double start on persistent request 'req[1]'.}}
+  MPI_Waitall(2, req, MPI_STATUSES_IGNORE);
+  MPI_Request_free(&req[0]);
+  MPI_Request_free(&req[1]);
+}
+
+void persistentRequestLeak() {
+  double buf = 0;
+  MPI_Request req;
+  MPI_Send_init(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req);
+  MPI_Start(&req);
+  MPI_Wait(&req, MPI_STATUS_IGNORE);
+} // expected-warning{{Persistent request 'req' is not freed.}}
+
+void testCompletes() {
+  double buf = 0;
+  int flag = 0;
+  MPI_Request req;
+  MPI_Irecv(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req);
+  MPI_Test(&req, &flag, MPI_STATUS_IGNORE);
+  if (!flag)
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+} // no error
+
+void testPending() {
+  double buf = 0;
+  int flag = 0;
+  MPI_Request req;
+  MPI_Irecv(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req);
+  MPI_Test(&req, &flag, MPI_STATUS_IGNORE);
+  if (flag)
+    return;
+} // expected-warning{{Request 'req' has no matching wait.}}
+
+void waitanyCompletes() {
+  double buf = 0;
+  int idx;
+  MPI_Request req[2];
+  MPI_Irecv(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req[0]);
+  MPI_Irecv(&buf, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD, &req[1]);
+  for (int i = 0; i < 2; ++i)
+    MPI_Waitany(2, req, &idx, MPI_STATUS_IGNORE);
+} // no error
+
+void fileOpenClose() {
+  MPI_File fh;
+  double buf = 0;
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_set_view(fh, 0, MPI_DOUBLE, MPI_DOUBLE, "native", MPI_INFO_NULL);
+  MPI_File_write(fh, &buf, 1, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+} // no error
+
+void doubleOpen() {
+  MPI_File fh;
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh); // expected-warning{{Double open on file 'fh'.}}
+  MPI_File_close(&fh);
+}
+
+void doubleClose() {
+  MPI_File fh;
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_close(&fh);
+  MPI_File_close(&fh); // expected-warning{{Double close on file 'fh'.}}
+}
+
+void accessAfterClose() {
+  MPI_File fh;
+  double buf = 0;
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_close(&fh);
+  MPI_File_write(fh, &buf, 1, MPI_DOUBLE, MPI_STATUS_IGNORE); // expected-warning{{File 'fh' is used after it was closed.}}
+}
+
+// The request of the nonblocking access is tracked on the reported path.
+void nonblockingAccessAfterClose() {
+  MPI_File fh;
+  MPI_Request req;
+  double buf = 0;
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_close(&fh);
+  MPI_File_iwrite(fh, &buf, 1, MPI_DOUBLE, &req); // expected-warning{{File 'fh' is used after it was closed.}}
+  MPI_Wait(&req, MPI_STATUS_IGNORE);
+}
+
+void setViewAfterClose() {
+  MPI_File fh;
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_close(&fh);
+  MPI_File_set_view(fh, 0, MPI_DOUBLE, MPI_DOUBLE, "native", MPI_INFO_NULL); // expected-warning{{File 'fh' is used after it was closed.}}
+}
+
+void accessUnopened() {
+  MPI_File fh;
+  double buf = 0;
+  MPI_File_read(fh, &buf, 1, MPI_DOUBLE, MPI_STATUS_IGNORE); // expected-warning{{File 'fh' is used without a matching open.}}
+}
+
+void accessPassedFile(MPI_File fh) {
+  double buf = 0;
+  MPI_File_read(fh, &buf, 1, MPI_DOUBLE, MPI_STATUS_IGNORE);
+} // no error
+
+void fileLeak() {
+  MPI_File fh;
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+} // expected-warning{{File 'fh' has no matching close.}}
+
+MPI_File globalFile;
+
+void openGlobalFile() {
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL,
+                &globalFile);
+} // no error
+
+int main() {
+  openGlobalFile();
+} // expected-warning{{File 'globalFile' has no matching close.}}
@@ -0,0 +1,122 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=optin.mpi.MPI-Checker,optin.mpi.MPI-Performance -verify %s
+
+// MPI-Checker test file to test the checks of data accesses against the view
+// set on a file.
+
+#include "MPIMock.h"
+
+void compute(double *);
+
+void matchingEType() {
+  MPI_File fh;
+  double buf[4] = {0};
+  MPI_Datatype block;
+  MPI_Type_contiguous(4, MPI_DOUBLE, &block);
+  MPI_Type_commit(&block);
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_set_view(fh, 0, MPI_DOUBLE, block, "native", MPI_INFO_NULL);
+  MPI_File_write(fh, buf, 4, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  MPI_File_write(fh, buf, 1, block, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+} // no warning
+
+void mismatchingEType() {
+  MPI_File fh;
+  int buf[4] = {0};
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_set_view(fh, 0, MPI_DOUBLE, MPI_DOUBLE, "native", MPI_INFO_NULL); // expected-note{{View is set here.}}
+  MPI_File_write(fh, buf, 4, MPI_INT, MPI_STATUS_IGNORE); // expected-warning{{Datatype of the access is not built from the etype of the view of file 'fh'.}}
+  MPI_File_close(&fh);
+}
+
+void mismatchingDerivedType() {
+  MPI_File fh;
+  int buf[4] = {0};
+  MPI_Datatype block;
+  MPI_Type_contiguous(4, MPI_INT, &block);
+  MPI_Type_commit(&block);
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_set_view(fh, 0, MPI_DOUBLE, MPI_DOUBLE, "native", MPI_INFO_NULL); // expected-note{{View is set here.}}
+  MPI_File_write(fh, buf, 1, block, MPI_STATUS_IGNORE); // expected-warning{{Datatype of the access is not built from the etype of the view of file 'fh'.}}
+  MPI_File_close(&fh);
+}
+
+void unknownEType(MPI_Datatype etype) {
+  MPI_File fh;
+  int buf[4] = {0};
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_set_view(fh, 0, etype, etype, "native", MPI_INFO_NULL);
+  MPI_File_write(fh, buf, 4, MPI_INT, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+} // no warning
+
+void independentStridedAccess(int rank) {
+  MPI_File fh;
+  double buf[16] = {0};
+  MPI_Datatype strided;
+  MPI_Type_vector(16, 1, 4, MPI_DOUBLE, &strided);
+  MPI_Type_commit(&strided);
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_set_view(fh, rank * sizeof(double), MPI_DOUBLE, strided, "native", // expected-note{{Noncontiguous view is set here.}}
+                    MPI_INFO_NULL);
+  MPI_File_write(fh, buf, 16, MPI_DOUBLE, MPI_STATUS_IGNORE); // expected-warning{{Independent access to file 'fh' through a noncontiguous view is split into one request per contiguous block, use 'MPI_File_write_all' to let the library merge the blocks of all processes.}}
+  MPI_File_close(&fh);
+}
+
+void collectiveStridedAccess(int rank) {
+  MPI_File fh;
+  double buf[16] = {0};
+  MPI_Datatype strided;
+  MPI_Type_vector(16, 1, 4, MPI_DOUBLE, &strided);
+  MPI_Type_commit(&strided);
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_set_view(fh, rank * sizeof(double), MPI_DOUBLE, strided, "native",
+                    MPI_INFO_NULL);
+  MPI_File_write_all(fh, buf, 16, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+} // no warning
+
+void independentSubarrayAccess() {
+  MPI_File fh;
+  double buf[16] = {0};
+  int sizes[2] = {8, 8}, subsizes[2] = {4, 4}, starts[2] = {0, 0};
+  MPI_Datatype tile;
+  MPI_Type_create_subarray(2, sizes, subsizes, starts, MPI_ORDER_C,
+                           MPI_DOUBLE, &tile);
+  MPI_Type_commit(&tile);
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_set_view(fh, 0, MPI_DOUBLE, tile, "native", MPI_INFO_NULL); // expected-note{{Noncontiguous view is set here.}}
+  MPI_File_read(fh, buf, 16, MPI_DOUBLE, MPI_STATUS_IGNORE); // expected-warning{{Independent access to file 'fh' through a noncontiguous view is split into one request per contiguous block, use 'MPI_File_read_all' to let the library merge the blocks of all processes.}}
+  MPI_File_close(&fh);
+}
+
+void viewResetByClose() {
+  MPI_File fh;
+  int buf[4] = {0};
+  MPI_Datatype strided;
+  MPI_Type_vector(4, 1, 4, MPI_DOUBLE, &strided);
+  MPI_Type_commit(&strided);
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_set_view(fh, 0, MPI_DOUBLE, strided, "native", MPI_INFO_NULL);
+  MPI_File_close(&fh);
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_write(fh, buf, 4, MPI_INT, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+} // no warning
+
+// The request of the nonblocking access is tracked on the reported path.
+void independentNonblockingStridedAccess(int rank) {
+  MPI_File fh;
+  MPI_Request req;
+  double buf[16] = {0}, work = 0;
+  MPI_Datatype strided;
+  MPI_Type_vector(16, 1, 4, MPI_DOUBLE, &strided);
+  MPI_Type_commit(&strided);
+  MPI_File_open(MPI_COMM_WORLD, "file", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_set_view(fh, rank * sizeof(double), MPI_DOUBLE, strided, "native", // expected-note{{Noncontiguous view is set here.}}
+                    MPI_INFO_NULL);
+  MPI_File_iwrite(fh, buf, 16, MPI_DOUBLE, &req); // expected-warning{{Independent access to file 'fh' through a noncontiguous view is split into one request per contiguous block, use 'MPI_File_iwrite_all' to let the library merge the blocks of all processes.}}
+  compute(&work);
+  MPI_Wait(&req, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+}
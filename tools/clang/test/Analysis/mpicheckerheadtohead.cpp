@@ -0,0 +1,80 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=optin.mpi.MPI-Performance -verify %s
+
+// MPI-Checker test file to test the detection of processes that both call a
+// blocking send to each other before receiving.
+
+#include "MPIMock.h"
+
+void compute(double *);
+
+void headToHead() {
+  int rank = 0;
+  double send = 0, recv = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (rank == 0) {
+    MPI_Send(&send, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD); // expected-note{{Blocking send is called here.}}
+    MPI_Recv(&recv, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE); // expected-warning{{Receive from rank 1 follows a blocking send to it, while rank 1 also sends first.}}
+  } else if (rank == 1) {
+    MPI_Send(&send, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD); // expected-note{{Rank 1 sends before receiving here.}}
+    MPI_Recv(&recv, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  }
+}
+
+// One side receives first, the exchange completes without buffering.
+void orderedExchange() {
+  int rank = 0;
+  double send = 0, recv = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (rank == 0) {
+    MPI_Send(&send, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD);
+    MPI_Recv(&recv, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  } else if (rank == 1) {
+    MPI_Recv(&recv, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    MPI_Send(&send, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+  }
+} // no warning
+
+void receivePostedFirst() {
+  int rank = 0;
+  double send = 0, recv = 0, work = 0;
+  MPI_Request req;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (rank == 0) {
+    MPI_Irecv(&recv, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD, &req);
+    MPI_Send(&send, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD);
+    compute(&work);
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+  } else if (rank == 1) {
+    MPI_Irecv(&recv, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req);
+    MPI_Send(&send, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+    compute(&work);
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+  }
+} // no warning
+
+void sendrecv() {
+  int rank = 0;
+  double send = 0, recv = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (rank == 0) {
+    MPI_Sendrecv(&send, 1, MPI_DOUBLE, 1, 0, &recv, 1, MPI_DOUBLE, 1, 0,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  } else if (rank == 1) {
+    MPI_Sendrecv(&send, 1, MPI_DOUBLE, 0, 0, &recv, 1, MPI_DOUBLE, 0, 0,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  }
+} // no warning
+
+// Buffered sends complete locally.
+void bufferedSends() {
+  int rank = 0;
+  double send = 0, recv = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (rank == 0) {
+    MPI_Bsend(&send, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD);
+    MPI_Recv(&recv, 1, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  } else if (rank == 1) {
+    MPI_Bsend(&send, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+    MPI_Recv(&recv, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  }
+} // no warning
@@ -32,3 +32,13 @@ void tripleNonblocking() {
 
   MPI_Wait(&sendReq, MPI_STATUS_IGNORE);
 }
+
+void doubleStart() {
+  double buf = 0;
+  MPI_Request req;
+  MPI_Send_init(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req);
+  MPI_Start(&req); // expected-note{{Request is previously started here.}}
+  MPI_Start(&req); // expected-warning{{Double start on persistent request 'req'.}} expected-note{{Double start on persistent request 'req'.}}
+  MPI_Wait(&req, MPI_STATUS_IGNORE);
+  MPI_Request_free(&req);
+}
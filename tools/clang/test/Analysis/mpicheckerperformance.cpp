@@ -0,0 +1,140 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=optin.mpi.MPI-Performance -analyzer-output=text -verify %s
+
+// MPI-Checker test file to test performance diagnostics.
+
+#include "MPIMock.h"
+
+void compute(double *);
+
+void noOverlap() {
+  double buf = 0;
+  MPI_Request sendReq;
+  MPI_Isend(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &sendReq); // expected-note{{Request is previously used by nonblocking call here.}}
+  MPI_Wait(&sendReq, MPI_STATUS_IGNORE); // expected-warning{{Request 'sendReq' is waited for right after its nonblocking call, no work overlaps the communication.}} expected-note{{Request 'sendReq' is waited for right after its nonblocking call, no work overlaps the communication.}}
+}
+
+// MPI calls in between do not count as work.
+void noOverlapOtherMPICall() {
+  double buf = 0, buf2 = 0;
+  MPI_Request sendReq;
+  MPI_Isend(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &sendReq); // expected-note{{Request is previously used by nonblocking call here.}}
+  MPI_Bcast(&buf2, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  MPI_Wait(&sendReq, MPI_STATUS_IGNORE); // expected-warning{{Request 'sendReq' is waited for right after its nonblocking call, no work overlaps the communication.}} expected-note{{Request 'sendReq' is waited for right after its nonblocking call, no work overlaps the communication.}}
+}
+
+void overlapCall() {
+  double buf = 0, work = 0;
+  MPI_Request recvReq;
+  MPI_Irecv(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &recvReq);
+  compute(&work);
+  MPI_Wait(&recvReq, MPI_STATUS_IGNORE);
+} // no warning
+
+void overlapStore() {
+  double buf = 0, work = 0;
+  MPI_Request recvReq;
+  MPI_Irecv(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &recvReq);
+  work = work * 2;
+  MPI_Wait(&recvReq, MPI_STATUS_IGNORE);
+} // no warning
+
+// Errors are only reported if MPI-Checker is enabled.
+void errorsNotReported() {
+  MPI_Request req;
+  MPI_Wait(&req, MPI_STATUS_IGNORE);
+} // no warning
+
+void spinningTest() {
+  double buf = 0;
+  int flag = 0;
+  MPI_Request req;
+  MPI_Irecv(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req);
+  while (!flag) // expected-note 2 {{Loop condition is true.  Entering loop body}}
+    MPI_Test(&req, &flag, MPI_STATUS_IGNORE); // expected-warning{{Request 'req' is tested again without work in between, use a wait instead of spinning.}} expected-note{{Request 'req' is tested again without work in between, use a wait instead of spinning.}}
+}
+
+void spinningTestsome() {
+  double buf[2] = {0};
+  int outcount = 0, indices[2];
+  MPI_Request req[2];
+  MPI_Irecv(&buf[0], 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req[0]);
+  MPI_Irecv(&buf[1], 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req[1]);
+  do { // expected-note{{Loop condition is true. Execution continues on line 63}}
+    MPI_Testsome(2, req, &outcount, indices, MPI_STATUSES_IGNORE); // expected-warning{{Request 'req[0]' is tested again without work in between, use a wait instead of spinning.}} expected-note{{Request 'req[0]' is tested again without work in between, use a wait instead of spinning.}}
+  } while (outcount == 0);
+  MPI_Waitall(2, req, MPI_STATUSES_IGNORE);
+}
+
+void testWithWork() {
+  double buf = 0, work = 0;
+  int flag = 0;
+  MPI_Request req;
+  MPI_Irecv(&buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req);
+  while (!flag) {
+    compute(&work);
+    MPI_Test(&req, &flag, MPI_STATUS_IGNORE);
+  }
+} // no warning
+
+void barrierAfterCollective() {
+  double local = 0, global = 0;
+  MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD); // expected-note{{Communicator is synchronized here.}}
+  MPI_Barrier(MPI_COMM_WORLD); // expected-warning{{Barrier is redundant, 'MPI_Allreduce' right before synchronizes the communicator as well.}} expected-note{{Barrier is redundant, 'MPI_Allreduce' right before synchronizes the communicator as well.}}
+}
+
+void barrierBeforeCollectiveInLoop() {
+  double local = 0, global = 0;
+  for (int i = 0; i < 2; ++i) { // expected-note{{Loop condition is true.  Entering loop body}}
+    MPI_Barrier(MPI_COMM_WORLD); // expected-note{{Barrier is called here.}}
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD); // expected-warning{{Barrier right before is redundant, 'MPI_Allreduce' synchronizes the communicator as well. Removing it saves one synchronization per loop iteration.}} expected-note{{Barrier right before is redundant, 'MPI_Allreduce' synchronizes the communicator as well. Removing it saves one synchronization per loop iteration.}}
+    local = global;
+  }
+}
+
+void barrierNotRedundant(MPI_Comm comm) {
+  double local = 0, global = 0;
+
+  // A broadcast does not synchronize.
+  MPI_Bcast(&global, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  // Work in between.
+  local = global;
+  MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  local = global;
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  // Different communicators.
+  MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, comm);
+  MPI_Barrier(MPI_COMM_WORLD);
+} // no warning
+
+void blockingCollective(double *field) {
+  double local = 0, global = 0;
+  MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD); // expected-note{{Blocking collective is called here.}}
+  compute(field);
+  field[0] = 1;
+  local = global; // expected-warning{{Buffer of 'MPI_Allreduce' is first used after 2 steps of independent work, 'MPI_Iallreduce' and a wait before this use let the work overlap.}} expected-note{{Buffer of 'MPI_Allreduce' is first used after 2 steps of independent work, 'MPI_Iallreduce' and a wait before this use let the work overlap.}}
+}
+
+void blockingCollectiveUsedByCall(double *field) {
+  double value = 0;
+  MPI_Bcast(&value, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD); // expected-note{{Blocking collective is called here.}}
+  compute(field);
+  compute(&value); // expected-warning{{Buffer of 'MPI_Bcast' is first used after 1 step of independent work, 'MPI_Ibcast' and a wait before this use let the work overlap.}} expected-note{{Buffer of 'MPI_Bcast' is first used after 1 step of independent work, 'MPI_Ibcast' and a wait before this use let the work overlap.}}
+}
+
+void blockingCollectiveUsedRightAway(double *field) {
+  double local = 0, global = 0;
+  MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  field[0] = global;
+  compute(field);
+} // no warning
+
+// Reading the send buffer does not end the overlap, writing it does.
+void blockingCollectiveSendBuffer(double *field) {
+  double local = 0, global = 0, copy = 0;
+  MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD); // expected-note{{Blocking collective is called here.}}
+  copy = local;
+  local = 1; // expected-warning{{Buffer of 'MPI_Allreduce' is first used after 1 step of independent work, 'MPI_Iallreduce' and a wait before this use let the work overlap.}} expected-note{{Buffer of 'MPI_Allreduce' is first used after 1 step of independent work, 'MPI_Iallreduce' and a wait before this use let the work overlap.}}
+}
@@ -0,0 +1,139 @@
+//===--- AllreduceBatchingCheck.cpp - clang-tidy--------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "AllreduceBatchingCheck.h"
+#include "MPIUtils.h"
+#include "TypeMismatchCheck.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Tooling/FixIt.h"
+#include "llvm/ADT/SmallPtrSet.h"
+
+using namespace clang::ast_matchers;
+using clang::ento::mpi::MPIFunctionClassifier;
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+void AllreduceBatchingCheck::registerMatchers(MatchFinder *Finder) {
+  Finder->addMatcher(
+      compoundStmt(
+          has(callExpr(callee(functionDecl(hasName("MPI_Allreduce"))))))
+          .bind("block"),
+      this);
+}
+
+static bool isInPlace(const Expr *Buffer, const ASTContext &Context) {
+  return tooling::fixit::getText(*Buffer, Context) == "MPI_IN_PLACE";
+}
+
+bool AllreduceBatchingCheck::isScalarAllreduce(
+    const CallExpr *CE, const MPIFunctionClassifier::Signature &Sig,
+    ASTContext &Context) {
+  const FunctionDecl *const Callee = CE->getDirectCallee();
+  if (!Callee || !Callee->getIdentifier() ||
+      getClassifier(Context).getSignature(Callee->getIdentifier()) != &Sig ||
+      CE->getNumArgs() != Sig.getNumArgs())
+    return false;
+
+  const auto *Count = dyn_cast<IntegerLiteral>(
+      CE->getArg(Sig.getArgIndex(MPIFunctionClassifier::Count))
+          ->IgnoreParenImpCasts());
+  if (!Count || Count->getValue() != 1)
+    return false;
+
+  // The elements are combined into an array of the datatype, which requires
+  // a standard datatype matching all buffers.
+  const std::string Datatype = tooling::fixit::getText(
+      *CE->getArg(Sig.getArgIndex(MPIFunctionClassifier::Datatype)), Context);
+  if (!isStandardMPIDatatype(Datatype))
+    return false;
+  for (const MPIFunctionClassifier::ArgRole Role :
+       {MPIFunctionClassifier::SendBuf, MPIFunctionClassifier::RecvBuf}) {
+    const Expr *const Buffer = CE->getArg(Sig.getArgIndex(Role));
+    if (isInPlace(Buffer, Context))
+      continue;
+    const Type *const BufferType = Buffer->IgnoreImpCasts()
+                                       ->getType()
+                                       .getTypePtr()
+                                       ->getPointeeOrArrayElementType();
+    std::string BufferTypeName;
+    if (BufferType->isVoidType() ||
+        !isBufferTypeMatching(BufferType, BufferTypeName, Datatype,
+                              getLangOpts()))
+      return false;
+  }
+  return true;
+}
+
+void AllreduceBatchingCheck::diagnoseBatch(ArrayRef<const CallExpr *> Batch) {
+  if (Batch.size() < 2)
+    return;
+  diag(Batch.front()->getLocStart(),
+       "%0 consecutive calls to MPI_Allreduce on single elements can be "
+       "batched into one call on an array")
+      << static_cast<unsigned>(Batch.size());
+  for (const CallExpr *CE : Batch.drop_front())
+    diag(CE->getLocStart(), "batched call", DiagnosticIDs::Note);
+}
+
+void AllreduceBatchingCheck::check(const MatchFinder::MatchResult &Result) {
+  const MPIFunctionClassifier &FuncClassifier = getClassifier(*Result.Context);
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier.getSignature(
+          &Result.Context->Idents.get("MPI_Allreduce"));
+  if (!Sig)
+    return;
+  const int SendIdx = Sig->getArgIndex(MPIFunctionClassifier::SendBuf);
+  const int RecvIdx = Sig->getArgIndex(MPIFunctionClassifier::RecvBuf);
+  ASTContext &Context = *Result.Context;
+
+  // A call continues the batch if it reduces with the same datatype,
+  // operation and communicator.
+  const auto isCompatible = [&](const CallExpr *First, const CallExpr *CE) {
+    for (const MPIFunctionClassifier::ArgRole Role :
+         {MPIFunctionClassifier::Datatype, MPIFunctionClassifier::Op,
+          MPIFunctionClassifier::Comm}) {
+      const int Idx = Sig->getArgIndex(Role);
+      if (!isSameExpr(First->getArg(Idx), CE->getArg(Idx), Context))
+        return false;
+    }
+    return true;
+  };
+
+  // Batches are formed from calls that are directly adjacent statements of
+  // the block. A call is not batched with previous calls, if one of its
+  // buffers refers to a variable a previous call reduced into.
+  const auto *Block = Result.Nodes.getNodeAs<CompoundStmt>("block");
+  SmallVector<const CallExpr *, 4> Batch;
+  llvm::SmallPtrSet<const VarDecl *, 8> Results;
+  for (const Stmt *Child : Block->body()) {
+    const auto *CE = dyn_cast<CallExpr>(Child);
+    const bool IsScalarAllreduce = CE && isScalarAllreduce(CE, *Sig, Context);
+
+    if (!Batch.empty() &&
+        (!IsScalarAllreduce || !isCompatible(Batch.front(), CE) ||
+         refersToAny(CE->getArg(SendIdx), Results) ||
+         refersToAny(CE->getArg(RecvIdx), Results))) {
+      diagnoseBatch(Batch);
+      Batch.clear();
+      Results.clear();
+    }
+    if (!IsScalarAllreduce)
+      continue;
+    Batch.push_back(CE);
+    collectVars(CE->getArg(RecvIdx), Results);
+  }
+  diagnoseBatch(Batch);
+}
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
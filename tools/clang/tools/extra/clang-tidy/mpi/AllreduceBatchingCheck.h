@@ -0,0 +1,50 @@
+//===--- AllreduceBatchingCheck.h - clang-tidy------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_ALLREDUCE_BATCHING_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_ALLREDUCE_BATCHING_H
+
+#include "../ClangTidy.h"
+#include "MPIUtils.h"
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+/// This check finds consecutive MPI (Message Passing Interface)
+/// MPI_Allreduce calls on single elements, that use the same datatype,
+/// operation and communicator and do not depend on each other. Each call
+/// pays the full latency of a reduction, while a single call on an array of
+/// the elements pays it once.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/mpi-allreduce-batching.html
+class AllreduceBatchingCheck : public MPICheck {
+public:
+  AllreduceBatchingCheck(StringRef Name, ClangTidyContext *Context)
+      : MPICheck(Name, Context) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+
+private:
+  /// Returns true if the call reduces a single element whose buffer types
+  /// match the datatype.
+  bool isScalarAllreduce(const CallExpr *CE,
+                         const ento::mpi::MPIFunctionClassifier::Signature &Sig,
+                         ASTContext &Context);
+
+  /// Diagnoses a sequence of calls that can be batched.
+  void diagnoseBatch(ArrayRef<const CallExpr *> Batch);
+};
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_ALLREDUCE_BATCHING_H
@@ -10,7 +10,6 @@
 #include "BufferDerefCheck.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
-#include "clang/StaticAnalyzer/Checkers/MPIFunctionClassifier.h"
 #include "clang/Tooling/FixIt.h"
 
 using namespace clang::ast_matchers;
@@ -19,74 +18,67 @@ namespace clang {
 namespace tidy {
 namespace mpi {
 
-// register the match with a callExpr() and bind it to "CE"
+// register the match with a call to an MPI function and bind it to "CE"
 void BufferDerefCheck::registerMatchers(MatchFinder *Finder) {
-  Finder->addMatcher(callExpr().bind("CE"), this);
+  // Only calls to MPI functions that take a buffer argument are matched, so
+  // that check() is not invoked for unrelated calls.
+  const std::vector<StringRef> Names =
+      ento::mpi::MPIFunctionClassifier::getFunctionNames(
+          [](const ento::mpi::MPIFunctionClassifier::Signature &Sig) {
+            return Sig.hasBuffer();
+          });
+  Finder->addMatcher(
+      callExpr(callee(functionDecl(hasAnyName(Names)))).bind("CE"), this);
 }
 
 // deliver the Result of the Match to the check
 void BufferDerefCheck::check(const MatchFinder::MatchResult &Result) {
-  static ento::mpi::MPIFunctionClassifier FuncClassifier(*Result.Context);
+  const ento::mpi::MPIFunctionClassifier &FuncClassifier =
+      getClassifier(*Result.Context);
+
   const auto *CE = Result.Nodes.getNodeAs<CallExpr>("CE");
   if (!CE->getDirectCallee())
     return;
 
   const IdentifierInfo *Identifier = CE->getDirectCallee()->getIdentifier();
-  if (!Identifier || !FuncClassifier.isMPIType(Identifier))
+  if (!Identifier)
+    return;
+  const ento::mpi::MPIFunctionClassifier::Signature *Sig =
+      FuncClassifier.getSignature(Identifier);
+  if (!Sig)
     return;
 
   // These containers are used, to capture the type and expression of a buffer.
   SmallVector<const Type *, 1> BufferTypes;
   SmallVector<const Expr *, 1> BufferExprs;
+  collectBuffers(*CE, *Sig, *Result.Context, BufferExprs);
+  for (const Expr *ArgExpr : BufferExprs)
+    BufferTypes.push_back(ArgExpr->IgnoreImpCasts()->getType().getTypePtr());
+
+  checkBuffers(BufferTypes, BufferExprs);
+}
+
+void collectBuffers(const CallExpr &CE,
+                    const ento::mpi::MPIFunctionClassifier::Signature &Sig,
+                    ASTContext &Context,
+                    SmallVectorImpl<const Expr *> &BufferExprs) {
+  // Collect the argument expressions for all buffers used in the MPI call
+  // expression, as described by the signature of the function.
+  const unsigned NumArgs = std::min(Sig.getNumArgs(), CE.getNumArgs());
+  for (unsigned Idx = 0; Idx < NumArgs; ++Idx) {
+    if (!Sig.isBuffer(Idx))
+      continue;
+    const Expr *ArgExpr = CE.getArg(Idx);
+    if (!ArgExpr || !ArgExpr->IgnoreImpCasts()->getType().getTypePtrOrNull())
+      continue;
 
-  // Adds the type and expression of a buffer that is used in the MPI call
-  // expression to the captured containers.
-  auto addBuffer = [&CE, &Result, &BufferTypes,
-                    &BufferExprs](const size_t BufferIdx) {
     // Skip null pointer constants and in place 'operators'.
-    if (CE->getArg(BufferIdx)->isNullPointerConstant(
-            *Result.Context, Expr::NPC_ValueDependentIsNull) ||
-        tooling::fixit::getText(*CE->getArg(BufferIdx), *Result.Context) ==
-            "MPI_IN_PLACE")
-      return;
-
-    const Expr *ArgExpr = CE->getArg(BufferIdx);
-    if (!ArgExpr)
-      return;
-    const Type *ArgType = ArgExpr->IgnoreImpCasts()->getType().getTypePtr();
-    if (!ArgType)
-      return;
+    if (ArgExpr->isNullPointerConstant(Context,
+                                       Expr::NPC_ValueDependentIsNull) ||
+        tooling::fixit::getText(*ArgExpr, Context) == "MPI_IN_PLACE")
+      continue;
     BufferExprs.push_back(ArgExpr);
-    BufferTypes.push_back(ArgType);
-  };
-
-  // Collect buffer types and argument expressions for all buffers used in the
-  // MPI call expression. The number passed to the lambda corresponds to the
-  // argument index of the currently verified MPI function call.
-  if (FuncClassifier.isPointToPointType(Identifier)) {
-    addBuffer(0);
-  } else if (FuncClassifier.isCollectiveType(Identifier)) {
-    if (FuncClassifier.isReduceType(Identifier)) {
-      addBuffer(0);
-      addBuffer(1);
-    } else if (FuncClassifier.isScatterType(Identifier) ||
-               FuncClassifier.isGatherType(Identifier) ||
-               FuncClassifier.isAlltoallType(Identifier)) {
-      addBuffer(0);
-      addBuffer(3);
-    } else if (FuncClassifier.isBcastType(Identifier)) {
-      addBuffer(0);
-    }
-  } else if(FuncClassifier.isMPIIO_Type(Identifier)){
-    if(FuncClassifier.isMPIIO_explicit_offset(Identifier)){
-      addBuffer(2);
-    } else if(FuncClassifier.isMPIIO_individual_file_pointers(Identifier) ||
-      FuncClassifier.isMPIIO_shared_file_pointer(Identifier)){
-      addBuffer(1);
-    }
   }
-
-  checkBuffers(BufferTypes, BufferExprs);
 }
 
 void BufferDerefCheck::checkBuffers(ArrayRef<const Type *> BufferTypes,
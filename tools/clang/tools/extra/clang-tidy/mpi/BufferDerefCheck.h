@@ -11,6 +11,7 @@
 #define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_BUFFER_DEREF_H
 
 #include "../ClangTidy.h"
+#include "MPIUtils.h"
 
 namespace clang {
 namespace tidy {
@@ -25,10 +26,10 @@ namespace mpi {
 ///
 /// For the user-facing documentation see:
 /// http://clang.llvm.org/extra/clang-tidy/checks/mpi-buffer-deref.html
-class BufferDerefCheck : public ClangTidyCheck {
+class BufferDerefCheck : public MPICheck {
 public:
   BufferDerefCheck(StringRef Name, ClangTidyContext *Context)
-      : ClangTidyCheck(Name, Context) {}
+      : MPICheck(Name, Context) {}
   void registerMatchers(ast_matchers::MatchFinder *Finder) override;
   void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
 
@@ -44,6 +45,19 @@ private:
   enum class IndirectionType : unsigned char { Pointer, Array };
 };
 
+/// Collects the buffer arguments of an MPI call, as described by the
+/// signature of the called function. Null pointer constants and
+/// MPI_IN_PLACE are skipped.
+///
+/// \param CE MPI call expression
+/// \param Sig signature of the called function
+/// \param Context AST context of the call
+/// \param BufferExprs buffer arguments as expressions, gets appended to
+void collectBuffers(const CallExpr &CE,
+                    const ento::mpi::MPIFunctionClassifier::Signature &Sig,
+                    ASTContext &Context,
+                    SmallVectorImpl<const Expr *> &BufferExprs);
+
 } // namespace mpi
 } // namespace tidy
 } // namespace clang
@@ -0,0 +1,147 @@
+//===--- CollectiveFusionCheck.cpp - clang-tidy----------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CollectiveFusionCheck.h"
+#include "MPIUtils.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Tooling/FixIt.h"
+
+using namespace clang::ast_matchers;
+using clang::ento::mpi::MPIFunctionClassifier;
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+void CollectiveFusionCheck::registerMatchers(MatchFinder *Finder) {
+  const std::vector<StringRef> BcastNames =
+      MPIFunctionClassifier::getFunctionNames(
+          [](const MPIFunctionClassifier::Signature &Sig) {
+            return (Sig.Categories & MPIFunctionClassifier::Bcast) &&
+                   !(Sig.Categories & MPIFunctionClassifier::NonBlocking);
+          });
+  Finder->addMatcher(
+      compoundStmt(has(callExpr(callee(functionDecl(hasAnyName(BcastNames))))))
+          .bind("block"),
+      this);
+}
+
+/// Returns the name of the collective that combines the rooted collective
+/// with a broadcast of its result, MPI_Reduce becomes MPI_Allreduce.
+static std::string fusedName(StringRef Name) {
+  return ("MPI_All" + Name.drop_front(4).lower());
+}
+
+void CollectiveFusionCheck::checkPair(const CallExpr *Collective,
+                                      const CallExpr *Bcast,
+                                      ASTContext &Context) {
+  const MPIFunctionClassifier &FuncClassifier = getClassifier(Context);
+  const FunctionDecl *const Callee = Collective->getDirectCallee();
+  const FunctionDecl *const BcastCallee = Bcast->getDirectCallee();
+  if (!Callee || !Callee->getIdentifier() || !BcastCallee)
+    return;
+
+  // Only blocking reductions and gathers to a root can be fused.
+  const uint64_t Categories =
+      FuncClassifier.getCategories(Callee->getIdentifier());
+  if (!(Categories & MPIFunctionClassifier::CollToPoint) ||
+      !(Categories &
+        (MPIFunctionClassifier::Reduce | MPIFunctionClassifier::Gather)) ||
+      (Categories & MPIFunctionClassifier::NonBlocking))
+    return;
+
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier.getSignature(Callee->getIdentifier());
+  const MPIFunctionClassifier::Signature *const BcastSig =
+      FuncClassifier.getSignature(BcastCallee->getIdentifier());
+  if (!Sig || !BcastSig || Sig->getNumArgs() != Collective->getNumArgs() ||
+      BcastSig->getNumArgs() != Bcast->getNumArgs())
+    return;
+
+  const std::string FusedName = fusedName(Callee->getName());
+  if (!FuncClassifier.isCollToColl(&Callee->getASTContext().Idents.get(
+          FusedName)))
+    return;
+
+  // The broadcast has to distribute the receive buffer of the collective from
+  // its root on the same communicator.
+  const int RecvIdx = Sig->getArgIndex(MPIFunctionClassifier::RecvBuf);
+  const int DatatypeIdx = Sig->getDatatypeIndex(RecvIdx);
+  const auto sameArg = [&](int Idx, MPIFunctionClassifier::ArgRole Role) {
+    const int BcastIdx = BcastSig->getArgIndex(Role);
+    return Idx >= 0 && BcastIdx >= 0 &&
+           isSameExpr(Collective->getArg(Idx), Bcast->getArg(BcastIdx),
+                      Context);
+  };
+  if (!sameArg(RecvIdx, MPIFunctionClassifier::RecvBuf) ||
+      !sameArg(DatatypeIdx, MPIFunctionClassifier::Datatype) ||
+      !sameArg(Sig->getArgIndex(MPIFunctionClassifier::Root),
+               MPIFunctionClassifier::Root) ||
+      !sameArg(Sig->getArgIndex(MPIFunctionClassifier::Comm),
+               MPIFunctionClassifier::Comm))
+    return;
+
+  // A reduction broadcasts as many elements as it reduces. The elements
+  // gathered depend on the size of the communicator and are not compared.
+  if ((Categories & MPIFunctionClassifier::Reduce) &&
+      !sameArg(Sig->getArgIndex(MPIFunctionClassifier::Count),
+               MPIFunctionClassifier::Count))
+    return;
+
+  auto Diag = diag(Collective->getLocStart(),
+                   "%0 followed by %1 of the result can be replaced by %2")
+              << Callee << BcastCallee << FusedName;
+
+  // The send buffer of a rooted collective often depends on the rank, as
+  // only the root may pass MPI_IN_PLACE. Such calls are not rewritten.
+  const int SendIdx = Sig->getArgIndex(MPIFunctionClassifier::SendBuf);
+  if (SendIdx < 0 ||
+      isa<ConditionalOperator>(
+          Collective->getArg(SendIdx)->IgnoreParenImpCasts()) ||
+      Collective->getLocStart().isMacroID() || Bcast->getLocEnd().isMacroID())
+    return;
+
+  // The fused collective takes the same arguments without the root.
+  std::string Replacement = FusedName + "(";
+  for (unsigned Idx = 0; Idx < Collective->getNumArgs(); ++Idx) {
+    if (Sig->getRole(Idx) == MPIFunctionClassifier::Root)
+      continue;
+    if (Replacement.back() != '(')
+      Replacement += ", ";
+    Replacement += tooling::fixit::getText(*Collective->getArg(Idx), Context);
+  }
+  Replacement += ")";
+  Diag << FixItHint::CreateReplacement(
+      SourceRange(Collective->getLocStart(), Bcast->getLocEnd()),
+      Replacement);
+}
+
+void CollectiveFusionCheck::check(const MatchFinder::MatchResult &Result) {
+  const MPIFunctionClassifier &FuncClassifier = getClassifier(*Result.Context);
+
+  // Only directly adjacent calls are fused, statements in between might use
+  // the buffer on the root before it is broadcast.
+  const auto *Block = Result.Nodes.getNodeAs<CompoundStmt>("block");
+  const CallExpr *Previous = nullptr;
+  for (const Stmt *Child : Block->body()) {
+    const auto *Call = dyn_cast<CallExpr>(Child);
+    if (Call && Previous) {
+      const FunctionDecl *const Callee = Call->getDirectCallee();
+      if (Callee && FuncClassifier.isBcastType(Callee->getIdentifier()) &&
+          !FuncClassifier.isNonBlockingType(Callee->getIdentifier()))
+        checkPair(Previous, Call, *Result.Context);
+    }
+    Previous = Call;
+  }
+}
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
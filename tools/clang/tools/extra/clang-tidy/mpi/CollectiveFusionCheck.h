@@ -0,0 +1,45 @@
+//===--- CollectiveFusionCheck.h - clang-tidy--------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_COLLECTIVE_FUSION_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_COLLECTIVE_FUSION_H
+
+#include "../ClangTidy.h"
+#include "MPIUtils.h"
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+/// This check finds an MPI (Message Passing Interface) reduction or gather
+/// to a root, that is directly followed by a broadcast of the result from the
+/// same root on the same communicator. Both steps are done by a single
+/// MPI_Allreduce or MPI_Allgather, which the pair is replaced with.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/mpi-collective-fusion.html
+class CollectiveFusionCheck : public MPICheck {
+public:
+  CollectiveFusionCheck(StringRef Name, ClangTidyContext *Context)
+      : MPICheck(Name, Context) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+
+private:
+  /// Checks if the broadcast distributes the result of the collective to the
+  /// root and diagnoses the pair.
+  void checkPair(const CallExpr *Collective, const CallExpr *Bcast,
+                 ASTContext &Context);
+};
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_COLLECTIVE_FUSION_H
@@ -0,0 +1,244 @@
+//===--- CollectiveIOCheck.cpp - clang-tidy--------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CollectiveIOCheck.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+
+using namespace clang::ast_matchers;
+using clang::ento::mpi::MPIFunctionClassifier;
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+void CollectiveIOCheck::registerMatchers(MatchFinder *Finder) {
+  const auto namesOf = [](uint64_t Category) {
+    return MPIFunctionClassifier::getFunctionNames(
+        [Category](const MPIFunctionClassifier::Signature &Sig) {
+          return Sig.Categories & Category;
+        });
+  };
+  Finder->addMatcher(
+      callExpr(callee(functionDecl(
+                   hasAnyName(namesOf(MPIFunctionClassifier::FileOpen)))))
+          .bind("open"),
+      this);
+  Finder->addMatcher(
+      callExpr(callee(functionDecl(
+                   hasAnyName(namesOf(MPIFunctionClassifier::CommRank)))),
+               forFunction(functionDecl().bind("function")))
+          .bind("rank"),
+      this);
+
+  const std::vector<StringRef> IndependentNames =
+      MPIFunctionClassifier::getFunctionNames(
+          [](const MPIFunctionClassifier::Signature &Sig) {
+            return (Sig.Categories & MPIFunctionClassifier::IODataAccess) &&
+                   !(Sig.Categories & MPIFunctionClassifier::IOCollective);
+          });
+  Finder->addMatcher(
+      callExpr(callee(functionDecl(hasAnyName(IndependentNames))))
+          .bind("access"),
+      this);
+}
+
+void CollectiveIOCheck::onStartOfTranslationUnit() {
+  MPICheck::onStartOfTranslationUnit();
+  Files.clear();
+  RankVars.clear();
+  RankFunctions.clear();
+  Accesses.clear();
+}
+
+/// Collects the conditions of the statements in a statement, under which
+/// they jump past the statements following it.
+static void collectExitGuards(const Stmt *S,
+                              SmallVectorImpl<const Expr *> &Guards) {
+  if (!S || isa<LambdaExpr>(S) || !containsJump(S))
+    return;
+  if (const auto *If = dyn_cast<IfStmt>(S))
+    Guards.push_back(If->getCond());
+  else if (const auto *Switch = dyn_cast<SwitchStmt>(S))
+    Guards.push_back(Switch->getCond());
+  else if (const auto *While = dyn_cast<WhileStmt>(S))
+    Guards.push_back(While->getCond());
+  else if (const auto *Do = dyn_cast<DoStmt>(S))
+    Guards.push_back(Do->getCond());
+  else if (const auto *For = dyn_cast<ForStmt>(S))
+    Guards.push_back(For->getCond());
+  for (const Stmt *Child : S->children())
+    collectExitGuards(Child, Guards);
+}
+
+/// Collects the conditions of the statements a call is nested in, up to the
+/// enclosing function. Conditional exits of the statements preceding the call
+/// in the enclosing blocks, like 'if (rank != 0) return;', guard it as well.
+static void collectGuards(const CallExpr *CE, ASTContext &Context,
+                          SmallVectorImpl<const Expr *> &Guards) {
+  ast_type_traits::DynTypedNode Node =
+      ast_type_traits::DynTypedNode::create(*CE);
+  const Stmt *Child = CE;
+  while (true) {
+    const auto Parents = Context.getParents(Node);
+    if (Parents.empty() ||
+        (Parents[0].get<Decl>() && !Parents[0].get<VarDecl>()))
+      return;
+    Node = Parents[0];
+    if (const auto *Block = Node.get<CompoundStmt>()) {
+      for (const Stmt *Previous : Block->body()) {
+        if (Previous == Child)
+          break;
+        collectExitGuards(Previous, Guards);
+      }
+    }
+    if (const auto *S = Node.get<Stmt>())
+      Child = S;
+    if (const auto *If = Node.get<IfStmt>())
+      Guards.push_back(If->getCond());
+    else if (const auto *Switch = Node.get<SwitchStmt>())
+      Guards.push_back(Switch->getCond());
+    else if (const auto *While = Node.get<WhileStmt>())
+      Guards.push_back(While->getCond());
+    else if (const auto *Do = Node.get<DoStmt>())
+      Guards.push_back(Do->getCond());
+    else if (const auto *For = Node.get<ForStmt>())
+      Guards.push_back(For->getCond());
+    else if (const auto *Cond = Node.get<ConditionalOperator>())
+      Guards.push_back(Cond->getCond());
+    else if (const auto *Logical = Node.get<BinaryOperator>()) {
+      if (Logical->isLogicalOp())
+        Guards.push_back(Logical->getLHS());
+    }
+  }
+}
+
+/// Collects the integer variables of a statement mapped to the values they
+/// are initialized with or assigned.
+static void collectDerivations(
+    const Stmt *S,
+    SmallVectorImpl<std::pair<const VarDecl *, const Expr *>> &Derivations) {
+  if (!S)
+    return;
+  if (const auto *Decls = dyn_cast<DeclStmt>(S)) {
+    for (const Decl *D : Decls->decls()) {
+      const auto *Var = dyn_cast<VarDecl>(D);
+      if (Var && Var->getType()->isIntegerType() && Var->getInit())
+        Derivations.push_back({Var, Var->getInit()});
+    }
+  } else if (const auto *Assign = dyn_cast<BinaryOperator>(S)) {
+    const auto *Ref =
+        dyn_cast<DeclRefExpr>(Assign->getLHS()->IgnoreParenImpCasts());
+    const auto *Var = Ref ? dyn_cast<VarDecl>(Ref->getDecl()) : nullptr;
+    if (Assign->getOpcode() == BO_Assign && Var &&
+        Var->getType()->isIntegerType())
+      Derivations.push_back({Var, Assign->getRHS()});
+  }
+  for (const Stmt *Child : S->children())
+    collectDerivations(Child, Derivations);
+}
+
+void CollectiveIOCheck::check(const MatchFinder::MatchResult &Result) {
+  const MPIFunctionClassifier &FuncClassifier = getClassifier(*Result.Context);
+
+  const CallExpr *CE = nullptr;
+  for (const char *ID : {"open", "rank", "access"}) {
+    if ((CE = Result.Nodes.getNodeAs<CallExpr>(ID)))
+      break;
+  }
+  const FunctionDecl *const Callee = CE->getDirectCallee();
+  if (!Callee || !Callee->getIdentifier())
+    return;
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier.getSignature(Callee->getIdentifier());
+  if (!Sig || Sig->getNumArgs() != CE->getNumArgs())
+    return;
+
+  // A file is only accessed by all processes, if it is opened by all of them.
+  if (Result.Nodes.getNodeAs<CallExpr>("open")) {
+    Files.recordOpen(CE, *Sig, *Result.Context);
+    return;
+  }
+
+  if (Result.Nodes.getNodeAs<CallExpr>("rank")) {
+    const int RankIdx = Sig->getArgIndex(MPIFunctionClassifier::Out);
+    if (RankIdx < 0)
+      return;
+    if (const VarDecl *const Rank = addressedVar(CE->getArg(RankIdx)))
+      RankVars.insert(Rank);
+    RankFunctions.insert(Result.Nodes.getNodeAs<FunctionDecl>("function"));
+    return;
+  }
+
+  const int FileIdx = Sig->getArgIndex(MPIFunctionClassifier::File);
+  if (FileIdx < 0)
+    return;
+  const VarDecl *const File = referencedVar(CE->getArg(FileIdx));
+  if (!File)
+    return;
+
+  const StringRef Collective =
+      MPIFunctionClassifier::getCollectiveCounterpart(Callee->getName());
+  if (Collective.empty())
+    return;
+
+  IndependentAccess Access{CE, File, Collective, {}};
+  collectGuards(CE, *Result.Context, Access.Guards);
+  Accesses.push_back(std::move(Access));
+}
+
+void CollectiveIOCheck::onEndOfTranslationUnit() {
+  // Variables computed from the rank, like 'IsRoot = Rank == 0', depend on it
+  // as well. They are only looked for in the functions querying the rank, and
+  // only if an access is guarded at all.
+  SmallVector<std::pair<const VarDecl *, const Expr *>, 8> Derivations;
+  if (std::any_of(Accesses.begin(), Accesses.end(),
+                  [](const IndependentAccess &Access) {
+                    return !Access.Guards.empty();
+                  })) {
+    for (const FunctionDecl *const FD : RankFunctions)
+      collectDerivations(FD->getBody(), Derivations);
+  }
+  for (bool Changed = true; Changed;) {
+    Changed = false;
+    for (const auto &Derivation : Derivations) {
+      if (!RankVars.count(Derivation.first) &&
+          refersToAny(Derivation.second, RankVars))
+        Changed |= RankVars.insert(Derivation.first).second;
+    }
+  }
+
+  for (const IndependentAccess &Access : Accesses) {
+    if (!Files.isShared(Access.File))
+      continue;
+
+    // Accesses depending on the rank are not executed by all processes.
+    if (std::any_of(Access.Guards.begin(), Access.Guards.end(),
+                    [this](const Expr *Guard) {
+                      return refersToAny(Guard, RankVars);
+                    }))
+      continue;
+
+    const Expr *const Callee = Access.Call->getCallee()->IgnoreImpCasts();
+    auto Diag =
+        diag(Access.Call->getLocStart(),
+             "%0 is called by all processes that opened the file; use the "
+             "collective %1 to let the library aggregate the accesses")
+        << Access.Call->getDirectCallee() << Access.Collective;
+    // Conditions not recognized as rank checks may still differ between the
+    // processes, which makes a collective call hang.
+    if (Access.Guards.empty() && !Callee->getLocStart().isMacroID())
+      Diag << FixItHint::CreateReplacement(Callee->getSourceRange(),
+                                           Access.Collective);
+  }
+}
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,68 @@
+//===--- CollectiveIOCheck.h - clang-tidy-----------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_COLLECTIVE_IO_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_COLLECTIVE_IO_H
+
+#include "../ClangTidy.h"
+#include "MPIUtils.h"
+#include "llvm/ADT/SmallPtrSet.h"
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+/// This check finds independent MPI (Message Passing Interface) file data
+/// access calls, that are not guarded by a condition on the rank, on files
+/// opened with a communicator other than MPI_COMM_SELF. As all processes
+/// access the file, the collective counterpart lets the library aggregate
+/// the accesses, for example by two-phase collective buffering. The callee
+/// of unconditional calls is replaced by the collective counterpart.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/mpi-collective-io.html
+class CollectiveIOCheck : public MPICheck {
+public:
+  CollectiveIOCheck(StringRef Name, ClangTidyContext *Context)
+      : MPICheck(Name, Context) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+  void onStartOfTranslationUnit() override;
+  void onEndOfTranslationUnit() override;
+
+private:
+  /// An independent access to a file handle variable.
+  struct IndependentAccess {
+    const CallExpr *Call;
+    const VarDecl *File;
+    StringRef Collective;
+    /// Conditions of the statements the call is nested in.
+    SmallVector<const Expr *, 2> Guards;
+  };
+
+  /// Files opened in the translation unit.
+  OpenedFiles Files;
+
+  /// Variables the rank of the process is written to, or that are computed
+  /// from such variables.
+  llvm::SmallPtrSet<const VarDecl *, 4> RankVars;
+
+  /// Functions querying the rank of the process.
+  llvm::SmallPtrSet<const FunctionDecl *, 4> RankFunctions;
+
+  /// Accesses are diagnosed at the end of the translation unit, as the files
+  /// and ranks they depend on are only known then.
+  SmallVector<IndependentAccess, 4> Accesses;
+};
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_COLLECTIVE_IO_H
@@ -0,0 +1,201 @@
+//===--- ExplicitOffsetCheck.cpp - clang-tidy------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ExplicitOffsetCheck.h"
+#include "MPIUtils.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Tooling/FixIt.h"
+
+using namespace clang::ast_matchers;
+using clang::ento::mpi::MPIFunctionClassifier;
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+void ExplicitOffsetCheck::registerMatchers(MatchFinder *Finder) {
+  const std::vector<StringRef> SeekNames =
+      MPIFunctionClassifier::getFunctionNames(
+          [](const MPIFunctionClassifier::Signature &Sig) {
+            return Sig.Categories & MPIFunctionClassifier::FileSeek;
+          });
+  Finder->addMatcher(
+      compoundStmt(has(callExpr(callee(functionDecl(hasAnyName(SeekNames))))))
+          .bind("block"),
+      this);
+}
+
+/// Returns the name of the explicit offset variant of an access through the
+/// individual file pointer, MPI_File_read_all becomes MPI_File_read_at_all.
+static std::string explicitOffsetName(StringRef Name) {
+  const std::pair<StringRef, StringRef> OpAndSuffix =
+      Name.drop_front(StringRef("MPI_File_").size()).split('_');
+  std::string ExplicitName = ("MPI_File_" + OpAndSuffix.first + "_at").str();
+  if (!OpAndSuffix.second.empty())
+    ExplicitName += ("_" + OpAndSuffix.second).str();
+  return ExplicitName;
+}
+
+/// Returns true if a call seeks to an absolute offset.
+static bool isAbsoluteSeek(const CallExpr *Call,
+                           const MPIFunctionClassifier &FuncClassifier,
+                           const ASTContext &Context) {
+  const FunctionDecl *const Callee = Call ? Call->getDirectCallee() : nullptr;
+  return Callee && FuncClassifier.isMPI_File_seek(Callee->getIdentifier()) &&
+         Call->getNumArgs() == 3 &&
+         tooling::fixit::getText(*Call->getArg(2), Context) == "MPI_SEEK_SET";
+}
+
+/// Creates the replacement of a seek and the access following it by the
+/// explicit offset variant of the access. Returns an empty hint if the pair
+/// cannot be replaced.
+static FixItHint createExplicitOffsetFix(
+    const CallExpr *Seek, const Expr *Offset, const CallExpr *Access,
+    int FileIdx, StringRef ExplicitName, ArrayRef<Stmt *>::iterator Following,
+    ArrayRef<Stmt *>::iterator End, const VarDecl *File,
+    const MPIFunctionClassifier &FuncClassifier, const ASTContext &Context) {
+  if (Seek->getLocStart().isMacroID() || Access->getLocEnd().isMacroID())
+    return FixItHint();
+
+  // The explicit offset variant does not move the file pointer, so the next
+  // use of the handle must not depend on it: it has to close the file or
+  // seek to an absolute offset again.
+  for (; Following != End; ++Following) {
+    llvm::SmallPtrSet<const VarDecl *, 8> Vars;
+    collectVars(*Following, Vars);
+    if (Vars.count(File))
+      break;
+  }
+  const auto *Use =
+      Following != End ? dyn_cast<CallExpr>(*Following) : nullptr;
+  const FunctionDecl *const UseCallee = Use ? Use->getDirectCallee() : nullptr;
+  if (!UseCallee ||
+      (!FuncClassifier.isMPI_File_close(UseCallee->getIdentifier()) &&
+       !isAbsoluteSeek(Use, FuncClassifier, Context)))
+    return FixItHint();
+
+  std::string Replacement = (ExplicitName + "(").str();
+  for (unsigned Idx = 0; Idx < Access->getNumArgs(); ++Idx) {
+    if (Idx > 0)
+      Replacement += ", ";
+    Replacement += tooling::fixit::getText(*Access->getArg(Idx), Context);
+    if (Idx == static_cast<unsigned>(FileIdx))
+      Replacement +=
+          (", " + tooling::fixit::getText(*Offset, Context)).str();
+  }
+  Replacement += ")";
+  return FixItHint::CreateReplacement(
+      SourceRange(Seek->getLocStart(), Access->getLocEnd()), Replacement);
+}
+
+void ExplicitOffsetCheck::checkSeek(const CallExpr *Seek, ArrayRef<Stmt *> Rest,
+                                    ASTContext &Context) {
+  const MPIFunctionClassifier &FuncClassifier = getClassifier(Context);
+  const FunctionDecl *const SeekCallee = Seek->getDirectCallee();
+  const MPIFunctionClassifier::Signature *const SeekSig =
+      FuncClassifier.getSignature(SeekCallee->getIdentifier());
+  if (!SeekSig || SeekSig->getNumArgs() != Seek->getNumArgs())
+    return;
+
+  // Only absolute offsets can be passed to the explicit offset variant.
+  const int FileIdx = SeekSig->getArgIndex(MPIFunctionClassifier::File);
+  const int OffsetIdx = SeekSig->getArgIndex(MPIFunctionClassifier::Offset);
+  if (FileIdx < 0 || OffsetIdx < 0 ||
+      !isAbsoluteSeek(Seek, FuncClassifier, Context))
+    return;
+  const VarDecl *const File = referencedVar(Seek->getArg(FileIdx));
+  if (!File)
+    return;
+  const Expr *const Offset = Seek->getArg(OffsetIdx);
+  llvm::SmallPtrSet<const VarDecl *, 4> OffsetVars;
+  collectVars(Offset, OffsetVars);
+
+  // Find the next use of the file handle. Statements in between must reach
+  // the access and keep the offset the same.
+  auto Next = Rest.begin();
+  for (; Next != Rest.end(); ++Next) {
+    llvm::SmallPtrSet<const VarDecl *, 8> Vars;
+    collectVars(*Next, Vars);
+    if (Vars.count(File))
+      break;
+    llvm::SmallPtrSet<const VarDecl *, 8> ModifiedVars;
+    collectModifiedVars(*Next, ModifiedVars);
+    if (containsJump(*Next) ||
+        std::any_of(OffsetVars.begin(), OffsetVars.end(),
+                    [&](const VarDecl *Var) {
+                      return ModifiedVars.count(Var);
+                    }))
+      return;
+  }
+  if (Next == Rest.end())
+    return;
+
+  const auto *Access = dyn_cast<CallExpr>(*Next);
+  const FunctionDecl *const Callee =
+      Access ? Access->getDirectCallee() : nullptr;
+  if (!Callee || !Callee->getIdentifier())
+    return;
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier.getSignature(Callee->getIdentifier());
+  if (!Sig || Sig->getNumArgs() != Access->getNumArgs() ||
+      !(Sig->Categories & MPIFunctionClassifier::IODataAccess) ||
+      !(Sig->Categories & MPIFunctionClassifier::IOIndividualFilePointer))
+    return;
+  const int AccessFileIdx = Sig->getArgIndex(MPIFunctionClassifier::File);
+  if (AccessFileIdx < 0 ||
+      referencedVar(Access->getArg(AccessFileIdx)) != File)
+    return;
+
+  // The explicit offset variant takes the offset right after the file.
+  const std::string ExplicitName = explicitOffsetName(Callee->getName());
+  const MPIFunctionClassifier::Signature *const ExplicitSig =
+      FuncClassifier.getSignature(
+          &Callee->getASTContext().Idents.get(ExplicitName));
+  if (!ExplicitSig ||
+      ExplicitSig->getArgIndex(MPIFunctionClassifier::Offset) !=
+          AccessFileIdx + 1 ||
+      ExplicitSig->getNumArgs() != Sig->getNumArgs() + 1)
+    return;
+
+  // Only adjacent calls are rewritten.
+  const FixItHint Fix =
+      Next == Rest.begin()
+          ? createExplicitOffsetFix(Seek, Offset, Access, AccessFileIdx,
+                                    ExplicitName, std::next(Next), Rest.end(),
+                                    File, FuncClassifier, Context)
+          : FixItHint();
+  {
+    auto Diag = diag(Access->getLocStart(), "%0 after %1 can be replaced by "
+                                            "%2, which takes the offset "
+                                            "directly")
+                << Callee << SeekCallee << ExplicitName;
+    if (!Fix.isNull())
+      Diag << Fix;
+  }
+  diag(Seek->getLocStart(), "file pointer is set here", DiagnosticIDs::Note);
+}
+
+void ExplicitOffsetCheck::check(const MatchFinder::MatchResult &Result) {
+  const MPIFunctionClassifier &FuncClassifier = getClassifier(*Result.Context);
+
+  const auto *Block = Result.Nodes.getNodeAs<CompoundStmt>("block");
+  const ArrayRef<Stmt *> Body =
+      llvm::makeArrayRef(Block->body_begin(), Block->body_end());
+  for (auto It = Body.begin(); It != Body.end(); ++It) {
+    const auto *Call = dyn_cast<CallExpr>(*It);
+    const FunctionDecl *const Callee = Call ? Call->getDirectCallee() : nullptr;
+    if (Callee && FuncClassifier.isMPI_File_seek(Callee->getIdentifier()))
+      checkSeek(Call, Body.drop_front(It - Body.begin() + 1), *Result.Context);
+  }
+}
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,52 @@
+//===--- ExplicitOffsetCheck.h - clang-tidy---------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_EXPLICIT_OFFSET_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_EXPLICIT_OFFSET_H
+
+#include "../ClangTidy.h"
+#include "MPIUtils.h"
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+/// This check finds calls to MPI_File_seek with an absolute offset, that are
+/// followed by a data access through the individual file pointer of the same
+/// MPI (Message Passing Interface) file handle. The explicit offset variant
+/// of the access, like MPI_File_read_at, takes the offset directly. It saves
+/// a library call, does not move the file pointer and is thread-safe.
+/// Directly adjacent pairs are replaced by the explicit offset variant, if
+/// the file pointer is not used afterwards.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/mpi-explicit-offset.html
+class ExplicitOffsetCheck : public MPICheck {
+public:
+  ExplicitOffsetCheck(StringRef Name, ClangTidyContext *Context)
+      : MPICheck(Name, Context) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+
+private:
+  /// Checks if the statements following a seek in a compound statement start
+  /// with an access through the individual file pointer of the file handle.
+  ///
+  /// \param Seek call to MPI_File_seek
+  /// \param Rest statements following the seek
+  /// \param Context AST context of the statements
+  void checkSeek(const CallExpr *Seek, ArrayRef<Stmt *> Rest,
+                 ASTContext &Context);
+};
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_EXPLICIT_OFFSET_H
@@ -10,8 +10,16 @@
 #include "../ClangTidy.h"
 #include "../ClangTidyModule.h"
 #include "../ClangTidyModuleRegistry.h"
+#include "AllreduceBatchingCheck.h"
 #include "BufferDerefCheck.h"
+#include "CollectiveFusionCheck.h"
+#include "CollectiveIOCheck.h"
+#include "ExplicitOffsetCheck.h"
+#include "MessageAggregationCheck.h"
+#include "PersistentRequestCheck.h"
+#include "SharedFilePointerCheck.h"
 #include "TypeMismatchCheck.h"
+#include "WaitInLoopCheck.h"
 
 namespace clang {
 namespace tidy {
@@ -20,8 +28,21 @@ namespace mpi {
 class MPIModule : public ClangTidyModule {
 public:
   void addCheckFactories(ClangTidyCheckFactories &CheckFactories) override {
+    CheckFactories.registerCheck<AllreduceBatchingCheck>(
+        "mpi-allreduce-batching");
     CheckFactories.registerCheck<BufferDerefCheck>("mpi-buffer-deref");
+    CheckFactories.registerCheck<CollectiveFusionCheck>(
+        "mpi-collective-fusion");
+    CheckFactories.registerCheck<CollectiveIOCheck>("mpi-collective-io");
+    CheckFactories.registerCheck<ExplicitOffsetCheck>("mpi-explicit-offset");
+    CheckFactories.registerCheck<MessageAggregationCheck>(
+        "mpi-message-aggregation");
+    CheckFactories.registerCheck<PersistentRequestCheck>(
+        "mpi-persistent-request");
+    CheckFactories.registerCheck<SharedFilePointerCheck>(
+        "mpi-shared-file-pointer");
     CheckFactories.registerCheck<TypeMismatchCheck>("mpi-type-mismatch");
+    CheckFactories.registerCheck<WaitInLoopCheck>("mpi-wait-in-loop");
   }
 };
 
@@ -0,0 +1,191 @@
+//===--- MPIUtils.cpp - clang-tidy-----------------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "MPIUtils.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Tooling/FixIt.h"
+#include "llvm/ADT/FoldingSet.h"
+
+using clang::ento::mpi::MPIFunctionClassifier;
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+const MPIFunctionClassifier &MPICheck::getClassifier(ASTContext &Context) {
+  if (!FuncClassifier)
+    FuncClassifier = llvm::make_unique<MPIFunctionClassifier>(Context);
+  return *FuncClassifier;
+}
+
+const VarDecl *addressedVar(const Expr *Arg) {
+  const auto *AddrOf = dyn_cast<UnaryOperator>(Arg->IgnoreParenImpCasts());
+  if (!AddrOf || AddrOf->getOpcode() != UO_AddrOf)
+    return nullptr;
+  const auto *Ref =
+      dyn_cast<DeclRefExpr>(AddrOf->getSubExpr()->IgnoreParenImpCasts());
+  return Ref ? dyn_cast<VarDecl>(Ref->getDecl()) : nullptr;
+}
+
+const VarDecl *referencedVar(const Expr *E) {
+  const auto *Ref = dyn_cast<DeclRefExpr>(E->IgnoreParenImpCasts());
+  return Ref ? dyn_cast<VarDecl>(Ref->getDecl()) : nullptr;
+}
+
+bool refersTo(const Expr *E, const VarDecl *Var) {
+  return Var && referencedVar(E) == Var;
+}
+
+void collectVars(const Stmt *S, llvm::SmallPtrSetImpl<const VarDecl *> &Vars) {
+  if (!S)
+    return;
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(S)) {
+    if (const auto *Var = dyn_cast<VarDecl>(Ref->getDecl()))
+      Vars.insert(Var);
+  }
+  for (const Stmt *Child : S->children())
+    collectVars(Child, Vars);
+}
+
+bool refersToAny(const Stmt *S,
+                 const llvm::SmallPtrSetImpl<const VarDecl *> &Vars) {
+  if (!S)
+    return false;
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(S)) {
+    if (const auto *Var = dyn_cast<VarDecl>(Ref->getDecl()))
+      return Vars.count(Var);
+  }
+  for (const Stmt *Child : S->children()) {
+    if (refersToAny(Child, Vars))
+      return true;
+  }
+  return false;
+}
+
+bool containsJump(const Stmt *S) {
+  if (!S || isa<LambdaExpr>(S))
+    return false;
+  if (isa<ReturnStmt>(S) || isa<GotoStmt>(S) || isa<BreakStmt>(S) ||
+      isa<ContinueStmt>(S) || isa<CXXThrowExpr>(S))
+    return true;
+  for (const Stmt *Child : S->children()) {
+    if (containsJump(Child))
+      return true;
+  }
+  return false;
+}
+
+bool isIntegerLiteral(const Expr *E, uint64_t Value) {
+  const auto *Literal = dyn_cast<IntegerLiteral>(E->IgnoreParenImpCasts());
+  return Literal && Literal->getValue() == Value;
+}
+
+bool isSameExpr(const Expr *LHS, const Expr *RHS, const ASTContext &Context) {
+  llvm::FoldingSetNodeID LHSID, RHSID;
+  LHS->IgnoreParenImpCasts()->Profile(LHSID, Context, true);
+  RHS->IgnoreParenImpCasts()->Profile(RHSID, Context, true);
+  return LHSID == RHSID && tooling::fixit::getText(*LHS, Context) ==
+                               tooling::fixit::getText(*RHS, Context);
+}
+
+bool startsAtZero(const Stmt *Init, const VarDecl *Counter) {
+  if (const auto *Decl = dyn_cast_or_null<DeclStmt>(Init)) {
+    return Decl->isSingleDecl() && Decl->getSingleDecl() == Counter &&
+           Counter->getInit() && isIntegerLiteral(Counter->getInit(), 0);
+  }
+  const auto *Assign = dyn_cast_or_null<BinaryOperator>(Init);
+  return Assign && Assign->getOpcode() == BO_Assign &&
+         refersTo(Assign->getLHS(), Counter) &&
+         isIntegerLiteral(Assign->getRHS(), 0);
+}
+
+void collectModifiedVars(const Stmt *S,
+                         llvm::SmallPtrSetImpl<const VarDecl *> &Vars) {
+  if (!S)
+    return;
+  const Expr *Target = nullptr;
+  if (const auto *BO = dyn_cast<BinaryOperator>(S)) {
+    if (BO->isAssignmentOp())
+      Target = BO->getLHS();
+  } else if (const auto *UO = dyn_cast<UnaryOperator>(S)) {
+    if (UO->isIncrementDecrementOp() || UO->getOpcode() == UO_AddrOf)
+      Target = UO->getSubExpr();
+  }
+  if (Target) {
+    if (const auto *Ref = dyn_cast<DeclRefExpr>(Target->IgnoreParenImpCasts()))
+      if (const auto *Var = dyn_cast<VarDecl>(Ref->getDecl()))
+        Vars.insert(Var);
+  }
+  for (const Stmt *Child : S->children())
+    collectModifiedVars(Child, Vars);
+}
+
+static bool isDeclaredIn(const VarDecl *Var, const Stmt *Loop,
+                         const SourceManager &SM) {
+  return SM.isBeforeInTranslationUnit(Loop->getLocStart(),
+                                      Var->getLocation()) &&
+         SM.isBeforeInTranslationUnit(Var->getLocation(), Loop->getLocEnd());
+}
+
+bool isLoopInvariant(const Stmt *S, const Stmt *Loop,
+                     const llvm::SmallPtrSetImpl<const VarDecl *> &ModifiedVars,
+                     const SourceManager &SM) {
+  if (isa<CallExpr>(S))
+    return false;
+
+  if (const auto *Ref = dyn_cast<DeclRefExpr>(S)) {
+    const auto *Var = dyn_cast<VarDecl>(Ref->getDecl());
+    return !Var || (!ModifiedVars.count(Var) && !isDeclaredIn(Var, Loop, SM));
+  }
+
+  // The address of a variable declared outside of the loop is the same in
+  // every iteration, even if the variable itself is modified.
+  if (const auto *UO = dyn_cast<UnaryOperator>(S)) {
+    if (UO->getOpcode() == UO_AddrOf) {
+      if (const auto *Ref =
+              dyn_cast<DeclRefExpr>(UO->getSubExpr()->IgnoreParens())) {
+        if (const auto *Var = dyn_cast<VarDecl>(Ref->getDecl()))
+          return !isDeclaredIn(Var, Loop, SM);
+      }
+    }
+  }
+
+  for (const Stmt *Child : S->children()) {
+    if (Child && !isLoopInvariant(Child, Loop, ModifiedVars, SM))
+      return false;
+  }
+  return true;
+}
+
+void OpenedFiles::recordOpen(const CallExpr *Open,
+                             const MPIFunctionClassifier::Signature &Sig,
+                             const ASTContext &Context) {
+  const int FileIdx = Sig.getArgIndex(MPIFunctionClassifier::OutFile);
+  const int CommIdx = Sig.getArgIndex(MPIFunctionClassifier::Comm);
+  if (FileIdx < 0 || CommIdx < 0)
+    return;
+  const VarDecl *const File = addressedVar(Open->getArg(FileIdx));
+  if (!File)
+    return;
+  const bool Shared =
+      tooling::fixit::getText(*Open->getArg(CommIdx), Context) !=
+      "MPI_COMM_SELF";
+  const auto Inserted = SharedFiles.insert({File, Shared});
+  if (!Inserted.second)
+    Inserted.first->second &= Shared;
+}
+
+bool OpenedFiles::isShared(const VarDecl *File) const {
+  const auto Shared = SharedFiles.find(File);
+  return Shared != SharedFiles.end() && Shared->second;
+}
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
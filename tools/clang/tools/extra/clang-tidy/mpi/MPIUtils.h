@@ -0,0 +1,131 @@
+//===--- MPIUtils.h - clang-tidy---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_MPI_UTILS_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_MPI_UTILS_H
+
+#include "../ClangTidy.h"
+#include "clang/AST/AST.h"
+#include "clang/StaticAnalyzer/Checkers/MPIFunctionClassifier.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include <memory>
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+/// Base of the checks classifying MPI functions. The classifier caches
+/// identifiers of the ASTContext it was created with. It is therefore created
+/// lazily for each translation unit.
+class MPICheck : public ClangTidyCheck {
+public:
+  MPICheck(StringRef Name, ClangTidyContext *Context)
+      : ClangTidyCheck(Name, Context) {}
+  void onStartOfTranslationUnit() override { FuncClassifier.reset(); }
+
+protected:
+  /// Returns the classifier of the translation unit the context belongs to.
+  const ento::mpi::MPIFunctionClassifier &getClassifier(ASTContext &Context);
+
+private:
+  std::unique_ptr<ento::mpi::MPIFunctionClassifier> FuncClassifier;
+};
+
+/// Returns the variable an expression refers to directly.
+const VarDecl *referencedVar(const Expr *E);
+
+/// Check if an expression refers directly to a variable.
+bool refersTo(const Expr *E, const VarDecl *Var);
+
+/// Collects the variables a statement refers to.
+///
+/// \param S statement to inspect, including its children, may be null
+/// \param Vars referenced variables, gets inserted into
+void collectVars(const Stmt *S, llvm::SmallPtrSetImpl<const VarDecl *> &Vars);
+
+/// Check if a statement refers to one of the variables.
+bool refersToAny(const Stmt *S,
+                 const llvm::SmallPtrSetImpl<const VarDecl *> &Vars);
+
+/// Check if a statement contains a jump that may skip the statements
+/// following it, like a return. Lambdas are not inspected.
+bool containsJump(const Stmt *S);
+
+/// Check if an expression is an integer literal of the given value.
+bool isIntegerLiteral(const Expr *E, uint64_t Value);
+
+/// Returns the variable of an argument of the form '&Var'.
+const VarDecl *addressedVar(const Expr *Arg);
+
+/// Check if two expressions are structurally identical, ignoring
+/// parentheses and implicit casts, and spelled the same. Handles are compared
+/// by their spelling as well, as an implementation may define different
+/// handles as equal constants.
+bool isSameExpr(const Expr *LHS, const Expr *RHS, const ASTContext &Context);
+
+/// Check if the init statement of a loop initializes its counter with zero,
+/// either by declaring it or by assigning it.
+///
+/// \param Init init statement of the loop, may be null
+/// \param Counter counter of the loop
+///
+/// \returns true if the counter starts at zero
+bool startsAtZero(const Stmt *Init, const VarDecl *Counter);
+
+/// Collects the variables a statement assigns, increments, decrements or
+/// takes the address of.
+///
+/// \param S statement to inspect, including its children
+/// \param Vars modified variables, gets inserted into
+void collectModifiedVars(const Stmt *S,
+                         llvm::SmallPtrSetImpl<const VarDecl *> &Vars);
+
+/// Check if a statement evaluates to the same value in every iteration of a
+/// loop. Calls are assumed to yield different values.
+///
+/// \param S statement to inspect
+/// \param Loop loop the statement is part of
+/// \param ModifiedVars variables modified in the loop
+/// \param SM source manager of the translation unit
+///
+/// \returns true if the statement is loop invariant
+bool isLoopInvariant(const Stmt *S, const Stmt *Loop,
+                     const llvm::SmallPtrSetImpl<const VarDecl *> &ModifiedVars,
+                     const SourceManager &SM);
+
+/// File handle variables opened by MPI_File_open. A file is shared if all
+/// calls opening it pass a communicator other than MPI_COMM_SELF.
+class OpenedFiles {
+public:
+  /// Records a call opening a file. Handles that are not variables are
+  /// ignored.
+  ///
+  /// \param Open call opening the file
+  /// \param Sig signature of the called function
+  /// \param Context context of the translation unit
+  void recordOpen(const CallExpr *Open,
+                  const ento::mpi::MPIFunctionClassifier::Signature &Sig,
+                  const ASTContext &Context);
+
+  /// Check if a file handle variable is only opened by several processes.
+  bool isShared(const VarDecl *File) const;
+
+  void clear() { SharedFiles.clear(); }
+
+private:
+  /// File handle variables mapped to true if they are shared.
+  llvm::DenseMap<const VarDecl *, bool> SharedFiles;
+};
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_MPI_UTILS_H
@@ -0,0 +1,180 @@
+//===--- MessageAggregationCheck.cpp - clang-tidy--------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "MessageAggregationCheck.h"
+#include "BufferDerefCheck.h"
+#include "MPIUtils.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Tooling/FixIt.h"
+
+using namespace clang::ast_matchers;
+using clang::ento::mpi::MPIFunctionClassifier;
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+void MessageAggregationCheck::registerMatchers(MatchFinder *Finder) {
+  // Only point-to-point calls transferring a single buffer are matched.
+  // Persistent requests are set up once, the count they are created with is
+  // not the size of a message per iteration.
+  const std::vector<StringRef> Names =
+      MPIFunctionClassifier::getFunctionNames(
+          [](const MPIFunctionClassifier::Signature &Sig) {
+            if (!(Sig.Categories & MPIFunctionClassifier::PointToPoint) ||
+                (Sig.Categories & MPIFunctionClassifier::PersistentInit) ||
+                Sig.getArgIndex(MPIFunctionClassifier::Count) < 0)
+              return false;
+            unsigned NumBuffers = 0;
+            for (unsigned Idx = 0; Idx < Sig.getNumArgs(); ++Idx)
+              NumBuffers += Sig.isBuffer(Idx);
+            return NumBuffers == 1;
+          });
+  Finder->addMatcher(
+      callExpr(callee(functionDecl(hasAnyName(Names))),
+               hasAncestor(
+                   forStmt(hasIncrement(unaryOperator(
+                               hasOperatorName("++"),
+                               hasUnaryOperand(declRefExpr(
+                                   to(varDecl().bind("counter")))))))
+                       .bind("loop")))
+          .bind("CE"),
+      this);
+}
+
+/// Returns the array of a buffer argument of the form '&Array[Counter]' or
+/// 'Array + Counter'.
+static const Expr *indexedArray(const Expr *Buffer, const VarDecl *Counter) {
+  Buffer = Buffer->IgnoreParenImpCasts();
+  if (const auto *AddrOf = dyn_cast<UnaryOperator>(Buffer)) {
+    if (AddrOf->getOpcode() != UO_AddrOf)
+      return nullptr;
+    const auto *Subscript = dyn_cast<ArraySubscriptExpr>(
+        AddrOf->getSubExpr()->IgnoreParenImpCasts());
+    if (!Subscript || !refersTo(Subscript->getIdx(), Counter))
+      return nullptr;
+    return Subscript->getBase()->IgnoreParenImpCasts();
+  }
+  if (const auto *Add = dyn_cast<BinaryOperator>(Buffer)) {
+    if (Add->getOpcode() != BO_Add)
+      return nullptr;
+    if (refersTo(Add->getRHS(), Counter) &&
+        Add->getLHS()->getType()->isAnyPointerType())
+      return Add->getLHS()->IgnoreParenImpCasts();
+    if (refersTo(Add->getLHS(), Counter) &&
+        Add->getRHS()->getType()->isAnyPointerType())
+      return Add->getRHS()->IgnoreParenImpCasts();
+  }
+  return nullptr;
+}
+
+/// Creates the replacement of a loop consisting of a single blocking call by
+/// one call transferring all elements. Returns an empty hint if the loop
+/// cannot be replaced.
+static FixItHint createAggregationFix(const ForStmt *Loop, const CallExpr *CE,
+                                      const VarDecl *Counter,
+                                      unsigned BufferIdx, unsigned CountIdx,
+                                      const Expr *Array,
+                                      const ASTContext &Context,
+                                      const SourceManager &SM) {
+  if (Loop->getLocStart().isMacroID() || Loop->getLocEnd().isMacroID())
+    return FixItHint();
+  const auto *Body = dyn_cast<CompoundStmt>(Loop->getBody());
+  if (Body ? Body->size() != 1 || Body->body_front() != CE
+           : Loop->getBody() != CE)
+    return FixItHint();
+  // A counter declared outside of the loop would lose its final value.
+  const auto *Init = dyn_cast_or_null<DeclStmt>(Loop->getInit());
+  if (!Init || !startsAtZero(Init, Counter))
+    return FixItHint();
+
+  const auto *Cond = dyn_cast_or_null<BinaryOperator>(Loop->getCond());
+  if (!Cond || Cond->getOpcode() != BO_LT || !refersTo(Cond->getLHS(), Counter))
+    return FixItHint();
+
+  // The array, the number of elements, the peer and the tag have to be the
+  // same in every iteration.
+  llvm::SmallPtrSet<const VarDecl *, 8> ModifiedVars;
+  collectModifiedVars(Loop, ModifiedVars);
+  if (!isLoopInvariant(Array, Loop, ModifiedVars, SM) ||
+      !isLoopInvariant(Cond->getRHS(), Loop, ModifiedVars, SM))
+    return FixItHint();
+  for (unsigned Idx = 0; Idx < CE->getNumArgs(); ++Idx) {
+    if (Idx != BufferIdx && Idx != CountIdx &&
+        !isLoopInvariant(CE->getArg(Idx), Loop, ModifiedVars, SM))
+      return FixItHint();
+  }
+
+  std::string Replacement =
+      (tooling::fixit::getText(*CE->getCallee(), Context) + "(").str();
+  for (unsigned Idx = 0; Idx < CE->getNumArgs(); ++Idx) {
+    if (Idx > 0)
+      Replacement += ", ";
+    const Expr *const Arg = Idx == BufferIdx
+                                ? Array
+                                : Idx == CountIdx ? Cond->getRHS()
+                                                  : CE->getArg(Idx);
+    Replacement += tooling::fixit::getText(*Arg, Context);
+  }
+  // A loop without braces ends before the semicolon of the call.
+  Replacement += Body ? ");" : ")";
+  return FixItHint::CreateReplacement(Loop->getSourceRange(), Replacement);
+}
+
+void MessageAggregationCheck::check(const MatchFinder::MatchResult &Result) {
+  const MPIFunctionClassifier &FuncClassifier = getClassifier(*Result.Context);
+
+  const auto *CE = Result.Nodes.getNodeAs<CallExpr>("CE");
+  const auto *Loop = Result.Nodes.getNodeAs<ForStmt>("loop");
+  const auto *Counter = Result.Nodes.getNodeAs<VarDecl>("counter");
+  const FunctionDecl *const Callee = CE->getDirectCallee();
+  if (!Callee || !Callee->getIdentifier())
+    return;
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier.getSignature(Callee->getIdentifier());
+  if (!Sig || Sig->getNumArgs() != CE->getNumArgs())
+    return;
+
+  // Only single elements are aggregated, larger messages are not rate bound.
+  const int CountIdx = Sig->getArgIndex(MPIFunctionClassifier::Count);
+  if (CountIdx < 0 || !isIntegerLiteral(CE->getArg(CountIdx), 1))
+    return;
+
+  SmallVector<const Expr *, 1> BufferExprs;
+  collectBuffers(*CE, *Sig, *Result.Context, BufferExprs);
+  if (BufferExprs.size() != 1)
+    return;
+  const Expr *const Array = indexedArray(BufferExprs.front(), Counter);
+  if (!Array)
+    return;
+
+  unsigned BufferIdx = 0;
+  while (CE->getArg(BufferIdx) != BufferExprs.front())
+    ++BufferIdx;
+
+  auto Diag = diag(CE->getLocStart(),
+                   "%0 transfers a single element of '%1' per iteration; "
+                   "transfer the elements with one call or a derived datatype")
+              << Callee << tooling::fixit::getText(*Array, *Result.Context);
+
+  // Nonblocking calls complete a request per element, which the loop body
+  // does not show the use of.
+  if (Sig->Categories & MPIFunctionClassifier::NonBlocking)
+    return;
+  const FixItHint Fix =
+      createAggregationFix(Loop, CE, Counter, BufferIdx, CountIdx, Array,
+                           *Result.Context, *Result.SourceManager);
+  if (!Fix.isNull())
+    Diag << Fix;
+}
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,41 @@
+//===--- MessageAggregationCheck.h - clang-tidy-----------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_MESSAGE_AGGREGATION_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_MESSAGE_AGGREGATION_H
+
+#include "../ClangTidy.h"
+#include "MPIUtils.h"
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+/// This check finds point-to-point MPI (Message Passing Interface) calls in
+/// loops, that transfer a single element of an array indexed by the loop
+/// counter. Such loops are bound by the message rate, a single call for the
+/// whole range or a derived datatype avoids the per message overhead. Loops
+/// that only consist of a blocking call with the same peer and tag in every
+/// iteration are replaced by a single call.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/mpi-message-aggregation.html
+class MessageAggregationCheck : public MPICheck {
+public:
+  MessageAggregationCheck(StringRef Name, ClangTidyContext *Context)
+      : MPICheck(Name, Context) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+};
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_MESSAGE_AGGREGATION_H
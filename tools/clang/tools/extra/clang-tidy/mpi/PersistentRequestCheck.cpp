@@ -0,0 +1,83 @@
+//===--- PersistentRequestCheck.cpp - clang-tidy---------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PersistentRequestCheck.h"
+#include "MPIUtils.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "llvm/ADT/SmallPtrSet.h"
+
+using namespace clang::ast_matchers;
+using clang::ento::mpi::MPIFunctionClassifier;
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+void PersistentRequestCheck::registerMatchers(MatchFinder *Finder) {
+  // Only nonblocking point-to-point calls have persistent counterparts.
+  const std::vector<StringRef> Names =
+      MPIFunctionClassifier::getFunctionNames(
+          [](const MPIFunctionClassifier::Signature &Sig) {
+            return (Sig.Categories & MPIFunctionClassifier::NonBlocking) &&
+                   (Sig.Categories & MPIFunctionClassifier::PointToPoint) &&
+                   Sig.getArgIndex(MPIFunctionClassifier::Request) >= 0;
+          });
+  Finder->addMatcher(
+      callExpr(callee(functionDecl(hasAnyName(Names))),
+               hasAncestor(stmt(anyOf(forStmt(), whileStmt(), doStmt(),
+                                      cxxForRangeStmt()))
+                               .bind("loop")))
+          .bind("CE"),
+      this);
+}
+
+void PersistentRequestCheck::check(const MatchFinder::MatchResult &Result) {
+  const MPIFunctionClassifier &FuncClassifier = getClassifier(*Result.Context);
+
+  const auto *CE = Result.Nodes.getNodeAs<CallExpr>("CE");
+  const auto *Loop = Result.Nodes.getNodeAs<Stmt>("loop");
+  const FunctionDecl *const Callee = CE->getDirectCallee();
+  if (!Callee || !Callee->getIdentifier())
+    return;
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier.getSignature(Callee->getIdentifier());
+  if (!Sig || Sig->getNumArgs() != CE->getNumArgs())
+    return;
+
+  // The persistent counterpart of MPI_I<name> is MPI_<name>_init.
+  const StringRef Name = Callee->getName();
+  if (!Name.startswith("MPI_I"))
+    return;
+  const std::string InitName = "MPI_" + Name.substr(5, 1).upper() +
+                               Name.drop_front(6).str() + "_init";
+  if (!FuncClassifier.isPersistentInit(
+          &Result.Context->Idents.get(InitName)))
+    return;
+
+  // All arguments but the request have to be the same in every iteration.
+  llvm::SmallPtrSet<const VarDecl *, 8> ModifiedVars;
+  collectModifiedVars(Loop, ModifiedVars);
+  for (unsigned Idx = 0; Idx < CE->getNumArgs(); ++Idx) {
+    if (Sig->getRole(Idx) == MPIFunctionClassifier::Request)
+      continue;
+    if (!isLoopInvariant(CE->getArg(Idx), Loop, ModifiedVars,
+                         *Result.SourceManager))
+      return;
+  }
+
+  diag(CE->getLocStart(), "%0 is called with the same arguments in every "
+                          "iteration; create a persistent request with %1 "
+                          "and start it with MPI_Start")
+      << Callee << InitName;
+}
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,40 @@
+//===--- PersistentRequestCheck.h - clang-tidy-------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_PERSISTENT_REQUEST_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_PERSISTENT_REQUEST_H
+
+#include "../ClangTidy.h"
+#include "MPIUtils.h"
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+/// This check finds nonblocking point-to-point MPI (Message Passing
+/// Interface) calls in loops, whose arguments are the same in every
+/// iteration. Such calls are candidates for persistent requests, which are
+/// set up once by MPI_Send_init or MPI_Recv_init and started by MPI_Start or
+/// MPI_Startall in each iteration.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/mpi-persistent-request.html
+class PersistentRequestCheck : public MPICheck {
+public:
+  PersistentRequestCheck(StringRef Name, ClangTidyContext *Context)
+      : MPICheck(Name, Context) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+};
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_PERSISTENT_REQUEST_H
@@ -0,0 +1,139 @@
+//===--- SharedFilePointerCheck.cpp - clang-tidy---------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "SharedFilePointerCheck.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+
+using namespace clang::ast_matchers;
+using clang::ento::mpi::MPIFunctionClassifier;
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+void SharedFilePointerCheck::registerMatchers(MatchFinder *Finder) {
+  const std::vector<StringRef> OpenNames =
+      MPIFunctionClassifier::getFunctionNames(
+          [](const MPIFunctionClassifier::Signature &Sig) {
+            return Sig.Categories & MPIFunctionClassifier::FileOpen;
+          });
+  Finder->addMatcher(
+      callExpr(callee(functionDecl(hasAnyName(OpenNames)))).bind("open"),
+      this);
+
+  // The ordered variants are collective and already coordinate the access.
+  const std::vector<StringRef> SharedNames =
+      MPIFunctionClassifier::getFunctionNames(
+          [](const MPIFunctionClassifier::Signature &Sig) {
+            return (Sig.Categories &
+                    MPIFunctionClassifier::IOSharedFilePointer) &&
+                   (Sig.Categories & MPIFunctionClassifier::IODataAccess) &&
+                   !(Sig.Categories & MPIFunctionClassifier::IOCollective);
+          });
+  Finder->addMatcher(
+      callExpr(callee(functionDecl(hasAnyName(SharedNames))),
+               anyOf(hasAncestor(stmt(anyOf(forStmt(), whileStmt(), doStmt(),
+                                            cxxForRangeStmt()))
+                                     .bind("loop")),
+                     anything()))
+          .bind("access"),
+      this);
+}
+
+void SharedFilePointerCheck::onStartOfTranslationUnit() {
+  MPICheck::onStartOfTranslationUnit();
+  Files.clear();
+  Accesses.clear();
+}
+
+void SharedFilePointerCheck::check(const MatchFinder::MatchResult &Result) {
+  const MPIFunctionClassifier &FuncClassifier = getClassifier(*Result.Context);
+
+  const auto *Open = Result.Nodes.getNodeAs<CallExpr>("open");
+  const CallExpr *const CE =
+      Open ? Open : Result.Nodes.getNodeAs<CallExpr>("access");
+  const FunctionDecl *const Callee = CE->getDirectCallee();
+  if (!Callee || !Callee->getIdentifier())
+    return;
+  const MPIFunctionClassifier::Signature *const Sig =
+      FuncClassifier.getSignature(Callee->getIdentifier());
+  if (!Sig || Sig->getNumArgs() != CE->getNumArgs())
+    return;
+
+  // Files opened by a single process are not contended.
+  if (Open) {
+    Files.recordOpen(CE, *Sig, *Result.Context);
+    return;
+  }
+
+  const int FileIdx = Sig->getArgIndex(MPIFunctionClassifier::File);
+  if (FileIdx < 0)
+    return;
+  const auto *FileRef =
+      dyn_cast<DeclRefExpr>(CE->getArg(FileIdx)->IgnoreParenImpCasts());
+  const auto *File = FileRef ? dyn_cast<VarDecl>(FileRef->getDecl()) : nullptr;
+  if (!File)
+    return;
+
+  // MPI_File_write_shared becomes MPI_File_write_ordered, the nonblocking
+  // variants have no ordered counterpart.
+  Accesses[File].push_back(
+      {CE, Result.Nodes.getNodeAs<Stmt>("loop") != nullptr,
+       MPIFunctionClassifier::getCollectiveCounterpart(Callee->getName())});
+}
+
+void SharedFilePointerCheck::onEndOfTranslationUnit() {
+  for (auto &FileAccesses : Accesses) {
+    // Accesses outside of loops are only reported for files known to be
+    // opened by several processes.
+    const bool IsShared = Files.isShared(FileAccesses.first);
+    SmallVector<SharedAccess, 4> Reported;
+    for (const SharedAccess &Access : FileAccesses.second) {
+      if (IsShared || Access.InLoop)
+        Reported.push_back(Access);
+    }
+    if (Reported.empty())
+      continue;
+
+    // Call sites in loops access the pointer most often and are listed first.
+    std::stable_partition(
+        Reported.begin(), Reported.end(),
+        [](const SharedAccess &Access) { return Access.InLoop; });
+    const unsigned InLoops = std::count_if(
+        Reported.begin(), Reported.end(),
+        [](const SharedAccess &Access) { return Access.InLoop; });
+
+    diag(Reported.front().Call->getLocStart(),
+         "shared file pointer of %0 is accessed at %1 call site%s1, %2 of "
+         "them in loops; each access serializes the processes on the pointer")
+        << FileAccesses.first << static_cast<unsigned>(Reported.size())
+        << InLoops;
+    for (const SharedAccess &Access : Reported) {
+      if (Access.Ordered.empty()) {
+        diag(Access.Call->getLocStart(),
+             "%0 %select{|in a loop }1accesses the shared file pointer; use "
+             "explicit offsets computed from the rank",
+             DiagnosticIDs::Note)
+            << Access.Call->getDirectCallee() << Access.InLoop;
+      } else {
+        diag(Access.Call->getLocStart(),
+             "%0 %select{|in a loop }1accesses the shared file pointer; use "
+             "%2 or explicit offsets computed from the rank",
+             DiagnosticIDs::Note)
+            << Access.Call->getDirectCallee() << Access.InLoop
+            << Access.Ordered;
+      }
+    }
+  }
+}
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,59 @@
+//===--- SharedFilePointerCheck.h - clang-tidy------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_SHARED_FILE_POINTER_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_SHARED_FILE_POINTER_H
+
+#include "../ClangTidy.h"
+#include "MPIUtils.h"
+#include "llvm/ADT/MapVector.h"
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+/// This check finds independent accesses through the shared file pointer of
+/// an MPI (Message Passing Interface) file handle, that are called in loops
+/// or on files opened with a communicator other than MPI_COMM_SELF. Most MPI
+/// implementations serialize such accesses of all processes through a lock
+/// on the shared file pointer. The call sites are reported per file handle,
+/// the ones in loops first.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/mpi-shared-file-pointer.html
+class SharedFilePointerCheck : public MPICheck {
+public:
+  SharedFilePointerCheck(StringRef Name, ClangTidyContext *Context)
+      : MPICheck(Name, Context) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+  void onStartOfTranslationUnit() override;
+  void onEndOfTranslationUnit() override;
+
+private:
+  /// An independent access through the shared file pointer.
+  struct SharedAccess {
+    const CallExpr *Call;
+    bool InLoop;
+    /// Ordered collective counterpart, empty if there is none.
+    StringRef Ordered;
+  };
+
+  /// Files opened in the translation unit.
+  OpenedFiles Files;
+
+  /// Accesses grouped by file handle variable, in order of appearance.
+  llvm::MapVector<const VarDecl *, SmallVector<SharedAccess, 4>> Accesses;
+};
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_SHARED_FILE_POINTER_H
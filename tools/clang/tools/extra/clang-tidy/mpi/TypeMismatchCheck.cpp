@@ -9,7 +9,6 @@
 
 #include "TypeMismatchCheck.h"
 #include "clang/Lex/Lexer.h"
-#include "clang/StaticAnalyzer/Checkers/MPIFunctionClassifier.h"
 #include "clang/Tooling/FixIt.h"
 #include <map>
 #include <unordered_set>
@@ -40,12 +39,7 @@ isMPITypeMatching(const std::multimap<BuiltinType::Kind, std::string> &MultiMap,
   return false;
 }
 
-/// Check if the MPI datatype is a standard type.
-///
-/// \param MPIDatatype name of the MPI datatype
-///
-/// \returns true if the type is a standard type
-static bool isStandardMPIDatatype(const std::string &MPIDatatype) {
+bool isStandardMPIDatatype(const std::string &MPIDatatype) {
   static std::unordered_set<std::string> AllTypes = {
       "MPI_C_BOOL",
       "MPI_CHAR",
@@ -237,18 +231,47 @@ static const Type *argumentType(const CallExpr *const CE, const size_t idx) {
   return QT.getTypePtr()->getPointeeOrArrayElementType();
 }
 
+bool isBufferTypeMatching(const Type *const BufferType,
+                          std::string &BufferTypeName,
+                          const std::string &MPIDatatype,
+                          const LangOptions &LO) {
+  if (const auto *Typedef = BufferType->getAs<TypedefType>())
+    return isTypedefTypeMatching(Typedef, BufferTypeName, MPIDatatype);
+  if (const auto *Complex = BufferType->getAs<ComplexType>())
+    return isCComplexTypeMatching(Complex, BufferTypeName, MPIDatatype, LO);
+  if (const auto *Template = BufferType->getAs<TemplateSpecializationType>())
+    return isCXXComplexTypeMatching(Template, BufferTypeName, MPIDatatype, LO);
+  if (const auto *Builtin = BufferType->getAs<BuiltinType>())
+    return isBuiltinTypeMatching(Builtin, BufferTypeName, MPIDatatype, LO);
+  return true;
+}
+
 void TypeMismatchCheck::registerMatchers(MatchFinder *Finder) {
-  Finder->addMatcher(callExpr().bind("CE"), this);
+  // Only calls to MPI functions that take a buffer argument are matched, so
+  // that check() is not invoked for unrelated calls.
+  const std::vector<StringRef> Names =
+      ento::mpi::MPIFunctionClassifier::getFunctionNames(
+          [](const ento::mpi::MPIFunctionClassifier::Signature &Sig) {
+            return Sig.hasBuffer();
+          });
+  Finder->addMatcher(
+      callExpr(callee(functionDecl(hasAnyName(Names)))).bind("CE"), this);
 }
 
 void TypeMismatchCheck::check(const MatchFinder::MatchResult &Result) {
-  static ento::mpi::MPIFunctionClassifier FuncClassifier(*Result.Context);
+  const ento::mpi::MPIFunctionClassifier &FuncClassifier =
+      getClassifier(*Result.Context);
+
   const auto *const CE = Result.Nodes.getNodeAs<CallExpr>("CE");
   if (!CE->getDirectCallee())
     return;
 
   const IdentifierInfo *Identifier = CE->getDirectCallee()->getIdentifier();
-  if (!Identifier || !FuncClassifier.isMPIType(Identifier))
+  if (!Identifier)
+    return;
+  const ento::mpi::MPIFunctionClassifier::Signature *Sig =
+      FuncClassifier.getSignature(Identifier);
+  if (!Sig)
     return;
 
   // These containers are used, to capture buffer, MPI datatype pairs.
@@ -280,29 +303,17 @@ void TypeMismatchCheck::check(const MatchFinder::MatchResult &Result) {
     MPIDatatypes.push_back(MPIDatatype);
   };
 
-  // Collect all buffer, MPI datatype pairs for the inspected call expression.
-  if (FuncClassifier.isPointToPointType(Identifier)) {
-    addPair(0, 2);
-  } else if (FuncClassifier.isCollectiveType(Identifier)) {
-    if (FuncClassifier.isReduceType(Identifier)) {
-      addPair(0, 3);
-      addPair(1, 3);
-    } else if (FuncClassifier.isScatterType(Identifier) ||
-               FuncClassifier.isGatherType(Identifier) ||
-               FuncClassifier.isAlltoallType(Identifier)) {
-      addPair(0, 2);
-      addPair(3, 5);
-    } else if (FuncClassifier.isBcastType(Identifier)) {
-      addPair(0, 2);
-    }
-  }else if(FuncClassifier.isMPIIO_Type(Identifier)){
-    if(FuncClassifier.isMPIIO_explicit_offset(Identifier)) {
-      addPair(2, 4);
-    } else if(FuncClassifier.isMPIIO_individual_file_pointers(Identifier) ||
-      FuncClassifier.isMPIIO_shared_file_pointer(Identifier)){
-      addPair(1, 3);
-    }
+  // Collect all buffer, MPI datatype pairs for the inspected call expression,
+  // as described by the signature of the function.
+  const unsigned NumArgs = std::min(Sig->getNumArgs(), CE->getNumArgs());
+  for (unsigned Idx = 0; Idx < NumArgs; ++Idx) {
+    if (!Sig->isBuffer(Idx))
+      continue;
+    const int DatatypeIdx = Sig->getDatatypeIndex(Idx);
+    if (DatatypeIdx >= 0 && static_cast<unsigned>(DatatypeIdx) < NumArgs)
+      addPair(Idx, DatatypeIdx);
   }
+
   checkArguments(BufferTypes, BufferExprs, MPIDatatypes, getLangOpts());
 }
 
@@ -313,23 +324,8 @@ void TypeMismatchCheck::checkArguments(ArrayRef<const Type *> BufferTypes,
   std::string BufferTypeName;
 
   for (size_t i = 0; i < MPIDatatypes.size(); ++i) {
-    const Type *const BT = BufferTypes[i];
-    bool Error = false;
-
-    if (const auto *Typedef = BT->getAs<TypedefType>()) {
-      Error = !isTypedefTypeMatching(Typedef, BufferTypeName, MPIDatatypes[i]);
-    } else if (const auto *Complex = BT->getAs<ComplexType>()) {
-      Error =
-          !isCComplexTypeMatching(Complex, BufferTypeName, MPIDatatypes[i], LO);
-    } else if (const auto *Template = BT->getAs<TemplateSpecializationType>()) {
-      Error = !isCXXComplexTypeMatching(Template, BufferTypeName,
-                                        MPIDatatypes[i], LO);
-    } else if (const auto *Builtin = BT->getAs<BuiltinType>()) {
-      Error =
-          !isBuiltinTypeMatching(Builtin, BufferTypeName, MPIDatatypes[i], LO);
-    }
-
-    if (Error) {
+    if (!isBufferTypeMatching(BufferTypes[i], BufferTypeName, MPIDatatypes[i],
+                              LO)) {
       const auto Loc = BufferExprs[i]->getSourceRange().getBegin();
       diag(Loc, "buffer type '%0' does not match the MPI datatype '%1'")
           << BufferTypeName << MPIDatatypes[i];
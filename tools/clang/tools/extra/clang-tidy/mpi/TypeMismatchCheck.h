@@ -11,6 +11,7 @@
 #define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_TYPE_MISMATCH_H
 
 #include "../ClangTidy.h"
+#include "MPIUtils.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
 
 namespace clang {
@@ -24,10 +25,10 @@ namespace mpi {
 ///
 /// For the user-facing documentation see:
 /// http://clang.llvm.org/extra/clang-tidy/checks/mpi-type-mismatch.html
-class TypeMismatchCheck : public ClangTidyCheck {
+class TypeMismatchCheck : public MPICheck {
 public:
   TypeMismatchCheck(StringRef Name, ClangTidyContext *Context)
-      : ClangTidyCheck(Name, Context) {}
+      : MPICheck(Name, Context) {}
 
   void registerMatchers(ast_matchers::MatchFinder *Finder) override;
   void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
@@ -44,6 +45,27 @@ private:
                       ArrayRef<StringRef> MPIDatatypes, const LangOptions &LO);
 };
 
+/// Check if the MPI datatype is a standard type.
+///
+/// \param MPIDatatype name of the MPI datatype
+///
+/// \returns true if the type is a standard type
+bool isStandardMPIDatatype(const std::string &MPIDatatype);
+
+/// Check if a buffer type matches a standard MPI datatype. Buffer types the
+/// datatype cannot be resolved for are considered matching.
+///
+/// \param BufferType unqualified, dereferenced buffer type
+/// \param BufferTypeName buffer type name, gets assigned on mismatch
+/// \param MPIDatatype name of the MPI datatype
+/// \param LO language options
+///
+/// \returns true if the type matches
+bool isBufferTypeMatching(const Type *const BufferType,
+                          std::string &BufferTypeName,
+                          const std::string &MPIDatatype,
+                          const LangOptions &LO);
+
 } // namespace mpi
 } // namespace tidy
 } // namespace clang
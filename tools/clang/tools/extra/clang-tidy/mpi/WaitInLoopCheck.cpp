@@ -0,0 +1,181 @@
+//===--- WaitInLoopCheck.cpp - clang-tidy----------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "WaitInLoopCheck.h"
+#include "MPIUtils.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Tooling/FixIt.h"
+
+using namespace clang::ast_matchers;
+using clang::ento::mpi::MPIFunctionClassifier;
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+void WaitInLoopCheck::registerMatchers(MatchFinder *Finder) {
+  const std::vector<StringRef> NonblockingNames =
+      MPIFunctionClassifier::getFunctionNames(
+          [](const MPIFunctionClassifier::Signature &Sig) {
+            return (Sig.Categories & MPIFunctionClassifier::NonBlocking) &&
+                   Sig.getArgIndex(MPIFunctionClassifier::Request) >= 0;
+          });
+  Finder->addMatcher(
+      callExpr(callee(functionDecl(hasAnyName(NonblockingNames))))
+          .bind("nonblocking"),
+      this);
+
+  const std::vector<StringRef> WaitNames =
+      MPIFunctionClassifier::getFunctionNames(
+          [](const MPIFunctionClassifier::Signature &Sig) {
+            return Sig.Categories & MPIFunctionClassifier::Wait;
+          });
+  const auto WaitCall =
+      callExpr(callee(functionDecl(hasAnyName(WaitNames)))).bind("wait");
+
+  // Only waits that are a statement of their own in the loop body are
+  // matched, waits depending on further conditions cannot be aggregated.
+  Finder->addMatcher(
+      forStmt(hasIncrement(unaryOperator(
+                  hasOperatorName("++"),
+                  hasUnaryOperand(declRefExpr(to(varDecl().bind("counter")))))),
+              hasBody(anyOf(WaitCall, compoundStmt(has(WaitCall)))))
+          .bind("loop"),
+      this);
+}
+
+void WaitInLoopCheck::onStartOfTranslationUnit() {
+  MPICheck::onStartOfTranslationUnit();
+  NonblockingArrays.clear();
+  WaitLoops.clear();
+}
+
+/// Returns the array of a request argument of the form '&Array[Index]'. If a
+/// counter is passed, the index has to refer to it.
+static const VarDecl *requestArray(const Expr *Arg,
+                                   const VarDecl *Counter = nullptr) {
+  const auto *AddrOf = dyn_cast<UnaryOperator>(Arg->IgnoreParenImpCasts());
+  if (!AddrOf || AddrOf->getOpcode() != UO_AddrOf)
+    return nullptr;
+  const auto *Subscript =
+      dyn_cast<ArraySubscriptExpr>(AddrOf->getSubExpr()->IgnoreParenImpCasts());
+  if (!Subscript)
+    return nullptr;
+  if (Counter) {
+    const auto *Index =
+        dyn_cast<DeclRefExpr>(Subscript->getIdx()->IgnoreParenImpCasts());
+    if (!Index || Index->getDecl() != Counter)
+      return nullptr;
+  }
+  const auto *Base =
+      dyn_cast<DeclRefExpr>(Subscript->getBase()->IgnoreParenImpCasts());
+  return Base ? dyn_cast<VarDecl>(Base->getDecl()) : nullptr;
+}
+
+/// Creates the replacement of a loop consisting of a single wait by a call to
+/// MPI_Waitall. Returns an empty hint if the loop cannot be replaced.
+static FixItHint createWaitallFix(const ForStmt *Loop, const CallExpr *Wait,
+                                  const VarDecl *Counter,
+                                  const VarDecl *Requests, int StatusIdx,
+                                  const ASTContext &Context) {
+  if (Loop->getLocStart().isMacroID() || Loop->getLocEnd().isMacroID())
+    return FixItHint();
+  const auto *Body = dyn_cast<CompoundStmt>(Loop->getBody());
+  if (Body && Body->size() != 1)
+    return FixItHint();
+  // A counter declared outside of the loop would lose its final value.
+  const auto *Init = dyn_cast_or_null<DeclStmt>(Loop->getInit());
+  if (!Init || !startsAtZero(Init, Counter))
+    return FixItHint();
+
+  const auto *Cond = dyn_cast_or_null<BinaryOperator>(Loop->getCond());
+  if (!Cond || Cond->getOpcode() != BO_LT || !refersTo(Cond->getLHS(), Counter))
+    return FixItHint();
+
+  // Ignored statuses stay ignored, an array of statuses indexed by the
+  // counter is passed as a whole.
+  std::string Statuses;
+  if (StatusIdx < 0 || static_cast<unsigned>(StatusIdx) >= Wait->getNumArgs())
+    return FixItHint();
+  const Expr *const Status = Wait->getArg(StatusIdx);
+  if (tooling::fixit::getText(*Status, Context) == "MPI_STATUS_IGNORE") {
+    Statuses = "MPI_STATUSES_IGNORE";
+  } else if (const VarDecl *StatusArray = requestArray(Status, Counter)) {
+    Statuses = StatusArray->getName();
+  } else {
+    return FixItHint();
+  }
+
+  // A loop without braces ends before the semicolon of the wait.
+  const std::string Replacement =
+      ("MPI_Waitall(" + tooling::fixit::getText(*Cond->getRHS(), Context) +
+       ", " + Requests->getName() + ", " + Statuses + ")" + (Body ? ";" : ""))
+          .str();
+  return FixItHint::CreateReplacement(Loop->getSourceRange(), Replacement);
+}
+
+void WaitInLoopCheck::check(const MatchFinder::MatchResult &Result) {
+  const MPIFunctionClassifier &FuncClassifier = getClassifier(*Result.Context);
+
+  // Collect the request arrays filled by nonblocking calls.
+  if (const auto *CE = Result.Nodes.getNodeAs<CallExpr>("nonblocking")) {
+    const FunctionDecl *const Callee = CE->getDirectCallee();
+    const MPIFunctionClassifier::Signature *const Sig =
+        Callee ? FuncClassifier.getSignature(Callee->getIdentifier())
+               : nullptr;
+    if (!Sig)
+      return;
+    const int ReqIdx = Sig->getArgIndex(MPIFunctionClassifier::Request);
+    if (ReqIdx < 0 || static_cast<unsigned>(ReqIdx) >= CE->getNumArgs())
+      return;
+    if (const VarDecl *const Requests = requestArray(CE->getArg(ReqIdx)))
+      NonblockingArrays.insert(Requests);
+    return;
+  }
+
+  const auto *Loop = Result.Nodes.getNodeAs<ForStmt>("loop");
+  const auto *Wait = Result.Nodes.getNodeAs<CallExpr>("wait");
+  const auto *Counter = Result.Nodes.getNodeAs<VarDecl>("counter");
+  const FunctionDecl *const Callee = Wait->getDirectCallee();
+  const MPIFunctionClassifier::Signature *const Sig =
+      Callee ? FuncClassifier.getSignature(Callee->getIdentifier()) : nullptr;
+  if (!Sig)
+    return;
+  const int ReqIdx = Sig->getArgIndex(MPIFunctionClassifier::Request);
+  if (ReqIdx < 0 || static_cast<unsigned>(ReqIdx) >= Wait->getNumArgs())
+    return;
+
+  // The loop has to wait for the element of the array the counter refers to.
+  const VarDecl *const Requests = requestArray(Wait->getArg(ReqIdx), Counter);
+  if (!Requests)
+    return;
+
+  WaitLoops.push_back(
+      {Requests, Wait->getLocStart(),
+       createWaitallFix(Loop, Wait, Counter, Requests,
+                        Sig->getArgIndex(MPIFunctionClassifier::Status),
+                        *Result.Context)});
+}
+
+void WaitInLoopCheck::onEndOfTranslationUnit() {
+  for (const WaitLoop &Loop : WaitLoops) {
+    if (!NonblockingArrays.count(Loop.Requests))
+      continue;
+    auto Diag = diag(Loop.Loc, "requests of %0 are waited for one at a time; "
+                               "use MPI_Waitall to complete them at once")
+                << Loop.Requests;
+    if (!Loop.Fix.isNull())
+      Diag << Loop.Fix;
+  }
+}
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
@@ -0,0 +1,58 @@
+//===--- WaitInLoopCheck.h - clang-tidy--------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_WAIT_IN_LOOP_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_WAIT_IN_LOOP_H
+
+#include "../ClangTidy.h"
+#include "MPIUtils.h"
+#include "llvm/ADT/SmallPtrSet.h"
+
+namespace clang {
+namespace tidy {
+namespace mpi {
+
+/// This check finds loops that complete the requests of an array one by one
+/// with MPI_Wait, where the array is filled by nonblocking MPI (Message
+/// Passing Interface) calls. A single MPI_Waitall lets the library complete
+/// the requests in the order they finish and avoids the per call overhead.
+/// Loops that only wait for the requests are replaced by MPI_Waitall.
+///
+/// For the user-facing documentation see:
+/// http://clang.llvm.org/extra/clang-tidy/checks/mpi-wait-in-loop.html
+class WaitInLoopCheck : public MPICheck {
+public:
+  WaitInLoopCheck(StringRef Name, ClangTidyContext *Context)
+      : MPICheck(Name, Context) {}
+  void registerMatchers(ast_matchers::MatchFinder *Finder) override;
+  void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+  void onStartOfTranslationUnit() override;
+  void onEndOfTranslationUnit() override;
+
+private:
+  /// A loop waiting for the requests of an array one at a time.
+  struct WaitLoop {
+    const VarDecl *Requests;
+    SourceLocation Loc;
+    FixItHint Fix;
+  };
+
+  /// Request arrays used by nonblocking calls.
+  llvm::SmallPtrSet<const VarDecl *, 4> NonblockingArrays;
+
+  /// Loops are diagnosed at the end of the translation unit, as the arrays
+  /// they wait for are only known to be filled by nonblocking calls then.
+  SmallVector<WaitLoop, 4> WaitLoops;
+};
+
+} // namespace mpi
+} // namespace tidy
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_MPI_WAIT_IN_LOOP_H
@@ -16,6 +16,7 @@ typedef int MPI_Status;
 typedef int MPI_Op;
 typedef int MPI_File;
 typedef int MPI_Offset;
+typedef int MPI_Info;
 typedef int int8_t;
 typedef int uint8_t;
 typedef int uint16_t;
@@ -44,29 +45,58 @@ namespace std { template<class T> struct complex { T real; T imag; }; }
 #define MPI_CXX_LONG_DOUBLE_COMPLEX 0
 #define MPI_IN_PLACE 0
 #define MPI_COMM_WORLD 0
+#define MPI_COMM_SELF 0
 #define MPI_STATUS_IGNORE 0
 #define MPI_STATUSES_IGNORE 0
 #define MPI_SUM 0
 #define MPI_INFO_NULL 0
+#define MPI_MODE_RDWR 0
+#define MPI_MODE_CREATE 0
+#define MPI_SEEK_SET 0
+#define MPI_SEEK_CUR 1
 
 // These declarations are used to mock MPI functions.
 int MPI_Comm_size(MPI_Comm, int *);
 int MPI_Comm_rank(MPI_Comm, int *);
 int MPI_Send(const void *, int, MPI_Datatype, int, int, MPI_Comm);
 int MPI_Recv(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Status *);
+int MPI_Sendrecv(const void *, int, MPI_Datatype, int, int, void *, int,
+    MPI_Datatype, int, int, MPI_Comm, MPI_Status *);
 int MPI_Isend(const void *, int, MPI_Datatype, int, int, MPI_Comm,
     MPI_Request *);
 int MPI_Irecv(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *);
+int MPI_Send_init(const void *, int, MPI_Datatype, int, int, MPI_Comm,
+    MPI_Request *);
+int MPI_Recv_init(void *, int, MPI_Datatype, int, int, MPI_Comm,
+    MPI_Request *);
+int MPI_Start(MPI_Request *);
+int MPI_Startall(int, MPI_Request[]);
+int MPI_Request_free(MPI_Request *);
 int MPI_Wait(MPI_Request *, MPI_Status *);
 int MPI_Waitall(int, MPI_Request[], MPI_Status[]);
 int MPI_Reduce(const void *, void *, int, MPI_Datatype, MPI_Op, int, MPI_Comm);
 int MPI_Ireduce(const void *, void *, int, MPI_Datatype, MPI_Op, int, MPI_Comm,
     MPI_Request *);
+int MPI_Allreduce(const void *, void *, int, MPI_Datatype, MPI_Op, MPI_Comm);
 int MPI_Bcast(void *, int count, MPI_Datatype, int, MPI_Comm);
+int MPI_Gather(const void *, int, MPI_Datatype, void *, int, MPI_Datatype, int,
+    MPI_Comm);
+int MPI_Allgather(const void *, int, MPI_Datatype, void *, int, MPI_Datatype,
+    MPI_Comm);
+int MPI_Gatherv(const void *, int, MPI_Datatype, void *, const int[],
+    const int[], MPI_Datatype, int, MPI_Comm);
+int MPI_File_open(MPI_Comm, const char *, int, MPI_Info, MPI_File *);
+int MPI_File_close(MPI_File *);
 int MPI_File_read(MPI_File, void *, int, MPI_Datatype, MPI_Status *);
 int MPI_File_write(MPI_File, const void *, int, MPI_Datatype, MPI_Status *);
 int MPI_File_read_at(MPI_File, MPI_Offset, void *, int, MPI_Datatype, MPI_Status *);
 int MPI_File_write_at(MPI_File, MPI_Offset, const void *, int, MPI_Datatype, MPI_Status *);
+int MPI_File_write_at_all(MPI_File, MPI_Offset, const void *, int,
+    MPI_Datatype, MPI_Status *);
+int MPI_File_read_all(MPI_File, void *, int, MPI_Datatype, MPI_Status *);
+int MPI_File_read_at_all(MPI_File, MPI_Offset, void *, int, MPI_Datatype,
+    MPI_Status *);
+int MPI_File_seek(MPI_File, MPI_Offset, int);
 int MPI_File_iread(MPI_File, void *, int, MPI_Datatype, MPI_Request *);
 int MPI_File_iwrite(MPI_File, const void *, int, MPI_Datatype, MPI_Request *);
 int MPI_File_iread_at(MPI_File, MPI_Offset, void *, int, MPI_Datatype, MPI_Request *);
@@ -75,5 +105,7 @@ int MPI_File_read_shared(MPI_File, void *, int, MPI_Datatype, MPI_Status *);
 int MPI_File_write_shared(MPI_File, const void *, int, MPI_Datatype, MPI_Status *);
 int MPI_File_iread_shared(MPI_File, void *, int, MPI_Datatype, MPI_Request *);
 int MPI_File_iwrite_shared(MPI_File, const void *, int, MPI_Datatype, MPI_Request *);
+int MPI_File_write_ordered(MPI_File, const void *, int, MPI_Datatype,
+    MPI_Status *);
 
 #endif  // end of include guard: MPIMOCK_H
@@ -0,0 +1,64 @@
+// RUN: %check_clang_tidy %s mpi-allreduce-batching %t -- -- -I %S/Inputs/mpi-type-mismatch
+
+#include "mpimock.h"
+
+void batch(MPI_Comm comm) {
+  double localResidual = 0, localError = 0, localNorm = 0;
+  double residual, error, norm;
+  MPI_Allreduce(&localResidual, &residual, 1, MPI_DOUBLE, MPI_SUM, comm);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: 3 consecutive calls to MPI_Allreduce on single elements can be batched into one call on an array [mpi-allreduce-batching]
+  MPI_Allreduce(&localError, &error, 1, MPI_DOUBLE, MPI_SUM, comm);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: note: batched call
+  MPI_Allreduce(&localNorm, &norm, 1, MPI_DOUBLE, MPI_SUM, comm);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: note: batched call
+}
+
+void inPlace() {
+  int converged = 0, iterations = 0;
+  MPI_Allreduce(MPI_IN_PLACE, &converged, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: 2 consecutive calls to MPI_Allreduce on single elements can be batched into one call on an array [mpi-allreduce-batching]
+  MPI_Allreduce(MPI_IN_PLACE, &iterations, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: note: batched call
+}
+
+void noBatch(MPI_Comm comm, MPI_Comm other, double *values) {
+  double local = 0, global = 0, scaled = 0;
+  int count = 0;
+
+  {
+    // The second call reduces the result of the first.
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, comm);
+    MPI_Allreduce(&global, &scaled, 1, MPI_DOUBLE, MPI_SUM, comm);
+  }
+
+  {
+    // Different communicators.
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, comm);
+    MPI_Allreduce(&local, &scaled, 1, MPI_DOUBLE, MPI_SUM, other);
+  }
+
+  {
+    // Different datatypes.
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, comm);
+    MPI_Allreduce(MPI_IN_PLACE, &count, 1, MPI_INT, MPI_SUM, comm);
+  }
+
+  {
+    // Arrays are not batched.
+    MPI_Allreduce(MPI_IN_PLACE, values, 4, MPI_DOUBLE, MPI_SUM, comm);
+    MPI_Allreduce(MPI_IN_PLACE, values + 4, 4, MPI_DOUBLE, MPI_SUM, comm);
+  }
+
+  {
+    // The buffer type does not match the datatype.
+    MPI_Allreduce(&local, &global, 1, MPI_INT, MPI_SUM, comm);
+    MPI_Allreduce(&local, &scaled, 1, MPI_INT, MPI_SUM, comm);
+  }
+
+  {
+    // Work in between.
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, comm);
+    local = global;
+    MPI_Allreduce(&local, &scaled, 1, MPI_DOUBLE, MPI_SUM, comm);
+  }
+}
@@ -0,0 +1,53 @@
+// RUN: %check_clang_tidy %s mpi-collective-fusion %t -- -- -I %S/Inputs/mpi-type-mismatch
+
+#include "mpimock.h"
+
+void reduceBcast() {
+  double local = 0, global = 0;
+  MPI_Reduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Bcast(&global, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  // CHECK-MESSAGES: :[[@LINE-2]]:3: warning: 'MPI_Reduce' followed by 'MPI_Bcast' of the result can be replaced by MPI_Allreduce [mpi-collective-fusion]
+  // CHECK-FIXES: {{^}}  MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);{{$}}
+}
+
+void gatherBcast(int *values, int n) {
+  int value = 0;
+  MPI_Gather(&value, 1, MPI_INT, values, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast(values, n, MPI_INT, 0, MPI_COMM_WORLD);
+  // CHECK-MESSAGES: :[[@LINE-2]]:3: warning: 'MPI_Gather' followed by 'MPI_Bcast' of the result can be replaced by MPI_Allgather [mpi-collective-fusion]
+  // CHECK-FIXES: {{^}}  MPI_Allgather(&value, 1, MPI_INT, values, 1, MPI_INT, MPI_COMM_WORLD);{{$}}
+}
+
+void inPlaceOnRoot(int rank) {
+  double sum = 0;
+  MPI_Reduce(rank == 0 ? MPI_IN_PLACE : &sum, &sum, 1, MPI_DOUBLE, MPI_SUM, 0,
+             MPI_COMM_WORLD);
+  MPI_Bcast(&sum, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  // CHECK-MESSAGES: :[[@LINE-3]]:3: warning: 'MPI_Reduce' followed by 'MPI_Bcast' of the result can be replaced by MPI_Allreduce [mpi-collective-fusion]
+  // CHECK-FIXES: {{^}}  MPI_Reduce(rank == 0 ? MPI_IN_PLACE : &sum, &sum, 1, MPI_DOUBLE, MPI_SUM, 0,{{$}}
+}
+
+void noFusion(double *work) {
+  double local = 0, global = 0, other = 0;
+
+  // The broadcast uses a different root.
+  MPI_Reduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Bcast(&global, 1, MPI_DOUBLE, 1, MPI_COMM_WORLD);
+
+  // The broadcast distributes a different buffer.
+  MPI_Reduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Bcast(&other, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+  // The root works on the result before it is broadcast.
+  MPI_Reduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  global = global / 2;
+  MPI_Bcast(&global, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+  // The broadcast uses a different communicator.
+  MPI_Reduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Bcast(&global, 1, MPI_DOUBLE, 0, MPI_COMM_SELF);
+
+  // Already fused.
+  MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Bcast(&global, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+}
@@ -0,0 +1,93 @@
+// RUN: %check_clang_tidy %s mpi-collective-io %t -- -- -I %S/Inputs/mpi-type-mismatch
+
+#include "mpimock.h"
+
+void allProcesses(double *buf, int n) {
+  int rank;
+  MPI_File fh;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_File_open(MPI_COMM_WORLD, "out", MPI_MODE_CREATE | MPI_MODE_RDWR,
+                MPI_INFO_NULL, &fh);
+  MPI_File_write_at(fh, rank * n, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: 'MPI_File_write_at' is called by all processes that opened the file; use the collective MPI_File_write_at_all to let the library aggregate the accesses [mpi-collective-io]
+  // CHECK-FIXES: {{^  }}MPI_File_write_at_all(fh, rank * n, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);{{$}}
+
+  MPI_File_read(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: 'MPI_File_read' is called by all processes that opened the file; use the collective MPI_File_read_all
+  // CHECK-FIXES: {{^  }}MPI_File_read_all(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);{{$}}
+
+  MPI_File_write_shared(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: 'MPI_File_write_shared' is called by all processes that opened the file; use the collective MPI_File_write_ordered
+  // CHECK-FIXES: {{^  }}MPI_File_write_ordered(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);{{$}}
+
+  // Guarded by a condition not depending on the rank.
+  if (n > 0)
+    MPI_File_write(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: 'MPI_File_write' is called by all processes that opened the file
+  // CHECK-FIXES: {{^  }}if (n > 0){{$}}
+  // CHECK-FIXES-NEXT: {{^    }}MPI_File_write(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);{{$}}
+
+  MPI_File_close(&fh);
+}
+
+void rankDependent(double *buf, int n) {
+  int rank;
+  MPI_File fh;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_File_open(MPI_COMM_WORLD, "out", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  if (rank == 0)
+    MPI_File_write_at(fh, 0, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  for (int i = 0; i < rank; ++i)
+    MPI_File_write(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+
+  // Conditions on variables computed from the rank.
+  int isRoot = rank == 0;
+  bool isLast;
+  isLast = isRoot || rank == n - 1;
+  if (isRoot)
+    MPI_File_read(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  if (isLast)
+    MPI_File_read_shared(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+
+  // Already collective.
+  MPI_File_write_at_all(fh, rank * n, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+}
+
+// Only rank 0 reaches the access.
+void earlyReturn(double *buf, int n) {
+  int rank;
+  MPI_File fh;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_File_open(MPI_COMM_WORLD, "out", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  if (rank != 0) {
+    MPI_File_close(&fh);
+    return;
+  }
+  MPI_File_write_at(fh, 0, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+}
+
+void earlyReturnNotOnRank(double *buf, int n) {
+  MPI_File fh;
+  MPI_File_open(MPI_COMM_WORLD, "out", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  if (n == 0) {
+    MPI_File_close(&fh);
+    return;
+  }
+  int rc = MPI_File_write(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  // CHECK-MESSAGES: :[[@LINE-1]]:12: warning: 'MPI_File_write' is called by all processes that opened the file
+  // CHECK-FIXES: {{^  }}int rc = MPI_File_write(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);{{$}}
+  MPI_File_close(&fh);
+}
+
+void selfOpened(double *buf, int n) {
+  MPI_File fh;
+  MPI_File_open(MPI_COMM_SELF, "local", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_write(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+}
+
+void unknownFile(MPI_File fh, double *buf, int n) {
+  MPI_File_write(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+}
@@ -0,0 +1,50 @@
+// RUN: %check_clang_tidy %s mpi-explicit-offset %t -- -- -I %S/Inputs/mpi-type-mismatch
+
+#include "mpimock.h"
+
+void compute(double *);
+
+void adjacent(MPI_File fh, double *buf, int n, int rank) {
+  MPI_File_seek(fh, rank * n, MPI_SEEK_SET);
+  MPI_File_read(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: 'MPI_File_read' after 'MPI_File_seek' can be replaced by MPI_File_read_at, which takes the offset directly [mpi-explicit-offset]
+  // CHECK-MESSAGES: :[[@LINE-3]]:3: note: file pointer is set here
+  // CHECK-FIXES: {{^  }}MPI_File_read_at(fh, rank * n, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);{{$}}
+
+  MPI_File_seek(fh, 0, MPI_SEEK_SET);
+  MPI_File_read_all(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: 'MPI_File_read_all' after 'MPI_File_seek' can be replaced by MPI_File_read_at_all
+  // CHECK-FIXES: {{^  }}MPI_File_read_at_all(fh, 0, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);{{$}}
+  MPI_File_close(&fh);
+}
+
+void notReplaced(MPI_File fh, double *buf, int n) {
+  // Work in between the seek and the access.
+  MPI_File_seek(fh, 0, MPI_SEEK_SET);
+  compute(buf);
+  MPI_File_write(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: 'MPI_File_write' after 'MPI_File_seek' can be replaced by MPI_File_write_at
+  // CHECK-FIXES: {{^  }}MPI_File_seek(fh, 0, MPI_SEEK_SET);{{$}}
+
+  // The next read depends on the file pointer moved by this one.
+  MPI_File_seek(fh, n, MPI_SEEK_SET);
+  MPI_File_read(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: warning: 'MPI_File_read' after 'MPI_File_seek' can be replaced by MPI_File_read_at
+  // CHECK-FIXES: {{^  }}MPI_File_seek(fh, n, MPI_SEEK_SET);{{$}}
+  MPI_File_read(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+}
+
+void noWarning(MPI_File fh, double *buf, int n, int offset) {
+  // Relative seek.
+  MPI_File_seek(fh, n, MPI_SEEK_CUR);
+  MPI_File_read(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+
+  // The offset changes in between.
+  MPI_File_seek(fh, offset, MPI_SEEK_SET);
+  ++offset;
+  MPI_File_read(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+
+  // Explicit offset access.
+  MPI_File_seek(fh, 0, MPI_SEEK_SET);
+  MPI_File_read_at(fh, 0, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+}
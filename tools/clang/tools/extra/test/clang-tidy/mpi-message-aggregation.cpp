@@ -0,0 +1,64 @@
+// RUN: %check_clang_tidy %s mpi-message-aggregation %t -- -- -I %S/Inputs/mpi-type-mismatch
+
+#include "mpimock.h"
+
+void compute(double *);
+
+void singleElements(double *values, int n, int right) {
+  for (int i = 0; i < n; ++i)
+    MPI_Send(&values[i], 1, MPI_DOUBLE, right, 0, MPI_COMM_WORLD);
+  // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: 'MPI_Send' transfers a single element of 'values' per iteration; transfer the elements with one call or a derived datatype [mpi-message-aggregation]
+  // CHECK-FIXES: {{^  }}MPI_Send(values, n, MPI_DOUBLE, right, 0, MPI_COMM_WORLD);{{$}}
+
+  double received[16];
+  for (int i = 0; i < 16; i++) {
+    MPI_Recv(received + i, 1, MPI_DOUBLE, right, 0, MPI_COMM_WORLD,
+             MPI_STATUS_IGNORE);
+  }
+  // CHECK-MESSAGES: :[[@LINE-3]]:5: warning: 'MPI_Recv' transfers a single element of 'received' per iteration
+  // CHECK-FIXES: {{^  }}MPI_Recv(received, 16, MPI_DOUBLE, right, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);{{$}}
+}
+
+void notReplaced(double *values, int n) {
+  // The peer depends on the loop counter.
+  for (int i = 0; i < n; ++i)
+    MPI_Send(&values[i], 1, MPI_DOUBLE, i, 0, MPI_COMM_WORLD);
+  // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: 'MPI_Send' transfers a single element of 'values' per iteration
+  // CHECK-FIXES: {{^    }}MPI_Send(&values[i], 1, MPI_DOUBLE, i, 0, MPI_COMM_WORLD);{{$}}
+
+  // The loop does further work.
+  for (int i = 1; i < n; ++i) {
+    MPI_Send(&values[i], 1, MPI_DOUBLE, 0, i, MPI_COMM_WORLD);
+    // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: 'MPI_Send' transfers a single element of 'values' per iteration
+    compute(values);
+  }
+
+  // Nonblocking calls create a request per element.
+  MPI_Request reqs[16];
+  for (int i = 0; i < 16; ++i)
+    MPI_Isend(&values[i], 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &reqs[i]);
+  // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: 'MPI_Isend' transfers a single element of 'values' per iteration
+  MPI_Waitall(16, reqs, MPI_STATUSES_IGNORE);
+
+  // The counter is declared outside of the loop and keeps its final value.
+  int i;
+  for (i = 0; i < n; ++i)
+    MPI_Send(&values[i], 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+  // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: 'MPI_Send' transfers a single element of 'values' per iteration
+  // CHECK-FIXES: {{^  }}for (i = 0; i < n; ++i){{$}}
+  // CHECK-FIXES-NEXT: {{^    }}MPI_Send(&values[i], 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);{{$}}
+  compute(values + i);
+}
+
+void noWarning(double *values, int n) {
+  // Whole rows are sent.
+  for (int i = 0; i < n; ++i)
+    MPI_Send(&values[i * n], n, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+
+  // The element does not depend on the loop counter.
+  for (int i = 0; i < n; ++i)
+    MPI_Send(&values[0], 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+
+  // Outside of a loop.
+  MPI_Send(&values[n], 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+}
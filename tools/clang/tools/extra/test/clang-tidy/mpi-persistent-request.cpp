@@ -0,0 +1,61 @@
+// RUN: %check_clang_tidy %s mpi-persistent-request %t -- -- -I %S/Inputs/mpi-type-mismatch
+
+#include "mpimock.h"
+
+void compute(double *);
+
+void invariantCalls(double *halo, int n, int left, int steps) {
+  MPI_Request req;
+  for (int step = 0; step < steps; ++step) {
+    MPI_Irecv(halo, n, MPI_DOUBLE, left, 0, MPI_COMM_WORLD, &req);
+    // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: 'MPI_Irecv' is called with the same arguments in every iteration; create a persistent request with MPI_Recv_init and start it with MPI_Start [mpi-persistent-request]
+    compute(halo);
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+  }
+
+  double value = 0;
+  MPI_Request reqs[4];
+  int i = 0;
+  while (i < 4) {
+    MPI_Isend(&value, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &reqs[i]);
+    // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: 'MPI_Isend' is called with the same arguments in every iteration; create a persistent request with MPI_Send_init
+    value = i++;
+  }
+  MPI_Waitall(4, reqs, MPI_STATUSES_IGNORE);
+}
+
+void variantCalls(double *buf, int n, int steps) {
+  MPI_Request req;
+  // The peer depends on the loop counter.
+  for (int step = 0; step < steps; ++step) {
+    MPI_Isend(buf, n, MPI_DOUBLE, step, 0, MPI_COMM_WORLD, &req);
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+  }
+
+  // The buffer is declared in the loop.
+  for (int step = 0; step < steps; ++step) {
+    double local = 0;
+    MPI_Isend(&local, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req);
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+  }
+
+  // The count is modified in the loop.
+  for (int step = 0; step < steps; ++step) {
+    MPI_Isend(buf, n, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req);
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+    n *= 2;
+  }
+
+  // The buffer pointer is advanced in the loop.
+  for (int step = 0; step < steps; ++step) {
+    MPI_Isend(buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req);
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+    ++buf;
+  }
+}
+
+void outsideOfLoop(double *buf) {
+  MPI_Request req;
+  MPI_Isend(buf, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, &req);
+  MPI_Wait(&req, MPI_STATUS_IGNORE);
+}
@@ -0,0 +1,42 @@
+// RUN: %check_clang_tidy %s mpi-shared-file-pointer %t -- -- -I %S/Inputs/mpi-type-mismatch
+
+#include "mpimock.h"
+
+void sharedFile(double *buf, int n, int steps) {
+  MPI_File fh;
+  MPI_Request req;
+  MPI_File_open(MPI_COMM_WORLD, "log", MPI_MODE_CREATE | MPI_MODE_RDWR,
+                MPI_INFO_NULL, &fh);
+  for (int step = 0; step < steps; ++step) {
+    MPI_File_iread_shared(fh, buf, n, MPI_DOUBLE, &req);
+    // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: shared file pointer of 'fh' is accessed at 2 call sites, 1 of them in loops; each access serializes the processes on the pointer [mpi-shared-file-pointer]
+    // CHECK-MESSAGES: :[[@LINE-2]]:5: note: 'MPI_File_iread_shared' in a loop accesses the shared file pointer; use explicit offsets computed from the rank
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+  }
+  MPI_File_write_shared(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  // CHECK-MESSAGES: :[[@LINE-1]]:3: note: 'MPI_File_write_shared' accesses the shared file pointer; use MPI_File_write_ordered or explicit offsets computed from the rank
+  MPI_File_close(&fh);
+}
+
+void unknownFile(MPI_File fh, double *buf, int n, int steps) {
+  int step = 0;
+  while (step++ < steps)
+    MPI_File_read_shared(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: shared file pointer of 'fh' is accessed at 1 call site, 1 of them in loops
+  // CHECK-MESSAGES: :[[@LINE-2]]:5: note: 'MPI_File_read_shared' in a loop accesses the shared file pointer; use MPI_File_read_ordered
+
+  // Outside of a loop on a file not known to be shared.
+  MPI_File_read_shared(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+}
+
+void noWarning(double *buf, int n, int steps) {
+  MPI_File fh;
+  MPI_File_open(MPI_COMM_SELF, "local", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  MPI_File_write_shared(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+
+  MPI_File_open(MPI_COMM_WORLD, "out", MPI_MODE_RDWR, MPI_INFO_NULL, &fh);
+  // The ordered variant is collective.
+  MPI_File_write_ordered(fh, buf, n, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+}
@@ -297,6 +297,20 @@ void complex_cxx_float_complexNegativeTest() {
   // CHECK-MESSAGES: :[[@LINE-1]]:21: warning: buffer type 'long double' does not match the MPI datatype 'MPI_CXX_FLOAT_COMPLEX'
 }
 
+void signatureTests() {
+  int buf;
+  char buf2;
+  MPI_Sendrecv(&buf, 1, MPI_INT, 0, 0, &buf2, 1, MPI_INT, 0, 0, MPI_COMM_WORLD,
+      MPI_STATUS_IGNORE);
+  // CHECK-MESSAGES: :[[@LINE-2]]:40: warning: buffer type 'char' does not match the MPI datatype 'MPI_INT'
+
+  int counts[1], displs[1];
+  short buf3[1];
+  MPI_Gatherv(&buf, 1, MPI_INT, buf3, counts, displs, MPI_INT, 0,
+      MPI_COMM_WORLD);
+  // CHECK-MESSAGES: :[[@LINE-2]]:33: warning: buffer type 'short' does not match the MPI datatype 'MPI_INT'
+}
+
 void skippedTypesTests() {
   // typedefs, user defined MPI and nullptr types are skipped
   typedef char CHAR;
@@ -0,0 +1,79 @@
+// RUN: %check_clang_tidy %s mpi-wait-in-loop %t -- -- -I %S/Inputs/mpi-type-mismatch
+
+#include "mpimock.h"
+
+void waitLoop() {
+  double buf[4];
+  MPI_Request reqs[4];
+  for (int i = 0; i < 4; ++i)
+    MPI_Irecv(&buf[i], 1, MPI_DOUBLE, i, 0, MPI_COMM_WORLD, &reqs[i]);
+
+  for (int i = 0; i < 4; ++i)
+    MPI_Wait(&reqs[i], MPI_STATUS_IGNORE);
+  // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: requests of 'reqs' are waited for one at a time; use MPI_Waitall to complete them at once [mpi-wait-in-loop]
+  // CHECK-FIXES: {{^}}  MPI_Waitall(4, reqs, MPI_STATUSES_IGNORE);{{$}}
+}
+
+void waitLoopBraces(int n) {
+  double buf = 0;
+  MPI_Request reqs[8];
+  MPI_Status stats[8];
+  for (int i = 0; i < n; ++i)
+    MPI_Isend(&buf, 1, MPI_DOUBLE, i, 0, MPI_COMM_WORLD, &reqs[i]);
+
+  for (int i = 0; i < n; i++) {
+    MPI_Wait(&reqs[i], &stats[i]);
+  }
+  // CHECK-MESSAGES: :[[@LINE-2]]:5: warning: requests of 'reqs' are waited
+  // CHECK-FIXES: {{^}}  MPI_Waitall(n, reqs, stats);{{$}}
+}
+
+void processInLoop(double *result) {
+  double buf[4];
+  MPI_Request reqs[4];
+  for (int i = 0; i < 4; ++i)
+    MPI_Irecv(&buf[i], 1, MPI_DOUBLE, i, 0, MPI_COMM_WORLD, &reqs[i]);
+
+  // The loop does more than waiting, so it is not replaced.
+  for (int i = 0; i < 4; ++i) {
+    MPI_Wait(&reqs[i], MPI_STATUS_IGNORE);
+    *result += buf[i];
+  }
+  // CHECK-MESSAGES: :[[@LINE-3]]:5: warning: requests of 'reqs' are waited
+  // CHECK-FIXES: {{^}}    MPI_Wait(&reqs[i], MPI_STATUS_IGNORE);{{$}}
+}
+
+int counterDeclaredOutside(int n) {
+  double buf = 0;
+  MPI_Request reqs[8];
+  for (int i = 0; i < n; ++i)
+    MPI_Isend(&buf, 1, MPI_DOUBLE, i, 0, MPI_COMM_WORLD, &reqs[i]);
+
+  // The counter keeps its final value, so the loop is not replaced.
+  int i;
+  for (i = 0; i < n; ++i)
+    MPI_Wait(&reqs[i], MPI_STATUS_IGNORE);
+  // CHECK-MESSAGES: :[[@LINE-1]]:5: warning: requests of 'reqs' are waited
+  // CHECK-FIXES: {{^}}  for (i = 0; i < n; ++i){{$}}
+  // CHECK-FIXES-NEXT: {{^}}    MPI_Wait(&reqs[i], MPI_STATUS_IGNORE);{{$}}
+  return i;
+}
+
+void negativeTests(int flag) {
+  MPI_Request reqs[4];
+  // The requests are not used by nonblocking calls.
+  for (int i = 0; i < 4; ++i)
+    MPI_Wait(&reqs[i], MPI_STATUS_IGNORE);
+
+  double buf = 0;
+  MPI_Request reqs2[4];
+  for (int i = 0; i < 4; ++i)
+    MPI_Isend(&buf, 1, MPI_DOUBLE, i, 0, MPI_COMM_WORLD, &reqs2[i]);
+  // The loop does not wait for the element of the counter.
+  for (int i = 0; i < 4; ++i)
+    MPI_Wait(&reqs2[0], MPI_STATUS_IGNORE);
+  // The wait depends on a condition.
+  for (int i = 0; i < 4; ++i)
+    if (flag)
+      MPI_Wait(&reqs2[i], MPI_STATUS_IGNORE);
+}